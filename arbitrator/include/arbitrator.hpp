@@ -23,6 +23,11 @@
 #include "planning_strategy.hpp"
 #include "capabilities_interface.hpp"
 #include <cav_msgs/GuidanceState.h>
+#include <cav_msgs/ManeuverPlan.h>
+#include <topic_tools/shape_shifter.h>
+#include <string>
+#include <vector>
+#include <functional>
 
 namespace arbitrator 
 {
@@ -45,6 +50,8 @@ namespace arbitrator
              * \param planning_strategy A planning strategy implementation for generating plans
              * \param min_plan_duration The minimum acceptable length of a plan
              * \param planning_frequency The frequency at which to generate high-level plans when engaged
+             * \param min_replan_interval The minimum time between the start of two plans when replanning is
+             * triggered early by an input change
              */ 
             Arbitrator(ros::CARMANodeHandle *nh, 
                 ros::CARMANodeHandle *pnh, 
@@ -52,7 +59,8 @@ namespace arbitrator
                 CapabilitiesInterface *ci, 
                 PlanningStrategy &planning_strategy,
                 ros::Duration min_plan_duration,
-                ros::Rate planning_frequency):
+                ros::Rate planning_frequency,
+                ros::Duration min_replan_interval = ros::Duration(0.2)):
                 sm_(sm),
                 nh_(nh),
                 pnh_(pnh),
@@ -60,14 +68,25 @@ namespace arbitrator
                 planning_strategy_(planning_strategy),
                 initialized_(false),
                 min_plan_duration_(min_plan_duration),
-                time_between_plans_(planning_frequency.expectedCycleTime()) {};
+                time_between_plans_(planning_frequency.expectedCycleTime()),
+                min_replan_interval_(min_replan_interval) {};
             
             /**
              * \brief Begin the operation of the arbitrator.
              * 
-             * Loops internally via ros::Duration sleeps and spins
+             * Loops internally, blocking on the ROS callback queue between planning cycles so
+             * that callbacks are handled as soon as they arrive
              */
             void run();
+
+            /**
+             * \brief Set a callback notified at the start of every planning cycle, before any plugin is queried
+             * \param observer The callback taking the planning start time, or an empty function to stop notifying
+             */
+            void set_planning_cycle_observer(std::function<void(const ros::Time&)> observer)
+            {
+                planning_cycle_observer_ = observer;
+            }
         protected:
             /**
              * \brief Function to be executed during the initial state of the Arbitrator
@@ -102,18 +121,52 @@ namespace arbitrator
              */
             void guidance_state_cb(const cav_msgs::GuidanceState::ConstPtr& msg);
 
+            /**
+             * \brief Callback for any message on a replan trigger topic. Requests a new plan
+             * as soon as the replan rate limit allows instead of at the next planning period
+             * \param msg The received message, its contents are not used
+             */
+            void replan_trigger_cb(const topic_tools::ShapeShifter::ConstPtr& msg);
+
+            /**
+             * \brief Get the time at which the next planning cycle should begin
+             * 
+             * This is the next periodic planning time, or the earliest time allowed by the
+             * replan rate limit if a replan has been requested by an input change
+             */
+            ros::Time get_next_planning_start() const;
+
+            /**
+             * \brief Process ROS callbacks as they arrive for at most the given duration
+             * \param timeout The maximum amount of time to block waiting for a callback
+             */
+            void wait_for_callbacks(const ros::Duration& timeout);
+
         private:
+            // Upper bound on a single blocking wait for callbacks so shutdown is noticed promptly
+            const ros::Duration IDLE_CALLBACK_TIMEOUT = ros::Duration(0.5);
+
             ArbitratorStateMachine *sm_;
             ros::Publisher final_plan_pub_;
+            ros::Publisher planning_metrics_pub_;
             ros::Subscriber guidance_state_sub_;
+            std::vector<ros::Subscriber> replan_trigger_subs_;
             ros::CARMANodeHandle *nh_;
             ros::CARMANodeHandle *pnh_;
             ros::Duration min_plan_duration_;
             ros::Duration time_between_plans_;
             ros::Time next_planning_process_start_;
+            ros::Duration min_replan_interval_;
+            ros::Time last_planning_process_start_;
+            bool replan_requested_ = false;
+            bool use_warm_start_ = false;
+            cav_msgs::ManeuverPlan last_published_plan_;
             CapabilitiesInterface *capabilities_interface_;
             PlanningStrategy &planning_strategy_;
             bool initialized_;
+            bool use_anytime_planning_ = false;
+            double planning_deadline_ratio_ = 0.8;
+            std::function<void(const ros::Time&)> planning_cycle_observer_;
     };
 };
 
@@ -18,7 +18,9 @@
 #define __ARBITRATOR_INCLUDE_ARBITRATOR_UTILS_HPP__
 
 #include <ros/ros.h>
+#include <string>
 #include <cav_msgs/ManeuverPlan.h>
+#include <cav_msgs/ManeuverParameters.h>
 
 /**
  * \brief Macro definition to enable easier access to fields shared across the maneuver typees
@@ -43,10 +45,10 @@ namespace arbitrator_utils
     /**
      * \brief Get the start time of the first maneuver in the plan
      * \param plan The plan to examine
-     * \return The ros::Time at which it starts
+     * \return A reference to the ros::Time at which it starts
      * \throws An invalid argument exception if the plan is empty
      */
-    ros::Time get_plan_start_time(const cav_msgs::ManeuverPlan&);
+    const ros::Time& get_plan_start_time(const cav_msgs::ManeuverPlan&);
 
     /**
      * \brief Get the start distance of the first maneuver in the plan
@@ -59,10 +61,10 @@ namespace arbitrator_utils
     /**
      * \brief Get the end time of the first maneuver in the plan
      * \param plan The plan to examine
-     * \return The ros::Time at which it ends
+     * \return A reference to the ros::Time at which it ends
      * \throws An invalid argument exception if the plan is empty
      */
-    ros::Time get_plan_end_time(const cav_msgs::ManeuverPlan&);
+    const ros::Time& get_plan_end_time(const cav_msgs::ManeuverPlan&);
 
     /**
      * \brief Get the end distance of the first maneuver in the plan
@@ -75,10 +77,10 @@ namespace arbitrator_utils
     /**
      * \brief Get the start time of the specified maneuver
      * \param mvr The maneuver to examine
-     * \return The ros::Time at which it starts
+     * \return A reference to the ros::Time at which it starts
      * \throws An invalid argument exception if the maneuver is poorly constructed
      */
-    ros::Time get_maneuver_start_time(const cav_msgs::Maneuver&);
+    const ros::Time& get_maneuver_start_time(const cav_msgs::Maneuver&);
 
     /**
      * \brief Get the start distance the specified maneuver
@@ -91,10 +93,10 @@ namespace arbitrator_utils
     /**
      * \brief Get the end time of the specified maneuver
      * \param mvr The maneuver to examine
-     * \return The ros::Time at which it ends
+     * \return A reference to the ros::Time at which it ends
      * \throws An invalid argument exception if the maneuver is poorly constructed
      */
-    ros::Time get_maneuver_end_time(const cav_msgs::Maneuver&);
+    const ros::Time& get_maneuver_end_time(const cav_msgs::Maneuver&);
 
     /**
      * \brief Get the end distance of the specified maneuver
@@ -103,6 +105,31 @@ namespace arbitrator_utils
      * \throws An invalid argument exception if the maneuver is poorly constructed
      */
     double get_maneuver_end_distance(const cav_msgs::Maneuver&);
+
+    /**
+     * \brief Get the parameters of the specified maneuver
+     * \param mvr The maneuver to examine
+     * \return A reference to the maneuver parameters held in mvr
+     * \throws An invalid argument exception if the maneuver is poorly constructed
+     */
+    const cav_msgs::ManeuverParameters& get_maneuver_parameters(const cav_msgs::Maneuver&);
+
+    /**
+     * \brief Build a key identifying the maneuver sequence of a plan. Other plan fields such as the ID are ignored.
+     * \param plan The plan to build the key for
+     * \return The serialized maneuvers of the plan
+     */
+    std::string get_maneuver_sequence_key(const cav_msgs::ManeuverPlan&);
+
+    /**
+     * \brief Get the part of a plan which has not yet expired
+     * \param plan The plan to examine
+     * \param time The time at which maneuvers ending at or before it are considered expired
+     * \return A copy of plan holding only the maneuvers from the first one which ends after time onward. The plan ID
+     *         is left empty as the result is a new plan once extended
+     * \throws An invalid argument exception if a maneuver is poorly constructed
+     */
+    cav_msgs::ManeuverPlan get_unexpired_plan(const cav_msgs::ManeuverPlan&, const ros::Time&);
 } // namespace arbitrator
 
 #endif //__ARBITRATOR_INCLUDE_ARBITRATOR_UTILS_HPP__
@@ -47,8 +47,10 @@ namespace arbitrator
                 beam_width_(beam_width) {};
 
             /**
-             * \brief Prioritize the plans and eliminate those outside the beam width
-             * \param plans The plans to evaluate as (plan, cot ) pairs
+             * \brief Prioritize the plans and eliminate those outside the beam width.
+             *      Only the plans within the beam width are sorted.
+             * \param plans The plans to evaluate as (plan, cot ) pairs. Callers should move
+             *      the list in to avoid copying the plans
              * \return The sorted list of up to size beam_width
              */
             std::vector<std::pair<cav_msgs::ManeuverPlan, double>> prioritize_plans(std::vector<std::pair<cav_msgs::ManeuverPlan, double>> plans) const;
@@ -23,11 +23,26 @@
 #include <map>
 #include <unordered_set>
 #include <string>
+#include <memory>
+#include <future>
 #include <cav_srvs/PluginList.h>
 #include <cav_srvs/GetPluginApi.h>
 
 namespace arbitrator
 {
+    /**
+     * \brief Accumulated statistics of the multiplexed service calls made to a single plugin
+     */
+    struct PluginCallStatistics
+    {
+        uint32_t calls = 0;
+        uint32_t failures = 0;
+        uint32_t timeouts = 0;
+        uint32_t skips = 0; // Calls not made as the plugin had not yet responded to a previous call
+        double total_latency_ms = 0.0; // Sum of the latencies of calls which returned before the timeout
+        double max_latency_ms = 0.0;
+    };
+
     /**
      * \brief Generic interface for interacting with Plugins via their capabilities
      *      instead of directly by their topics.
@@ -38,11 +53,23 @@ namespace arbitrator
             /**
              * \brief Constructor for Capabilities interface
              * \param nh A publically addressesed ("/") ros::NodeHandle
+             * \param plugin_call_timeout The maximum time to wait for plugins to respond to a multiplexed
+             *      service call. Plugins which have not responded are left out of the responses.
              */
-            CapabilitiesInterface(ros::NodeHandle *nh): nh_(nh) {
+            CapabilitiesInterface(ros::NodeHandle *nh, ros::WallDuration plugin_call_timeout = ros::WallDuration(0.5)):
+                nh_(nh),
+                plugin_call_timeout_(plugin_call_timeout) {
                 sc_s = nh_->serviceClient<cav_srvs::GetPluginApi>("plugins/get_strategic_plugin_by_capability");
             };
 
+            /**
+             * \brief Destructor, cancels the plugin calls which are still outstanding and waits for them to finish
+             */
+            ~CapabilitiesInterface();
+
+            CapabilitiesInterface(const CapabilitiesInterface&) = delete;
+            CapabilitiesInterface& operator=(const CapabilitiesInterface&) = delete;
+
             /**
              * \brief Initialize the Capabilities interface by querying the Health Monitor
              *      node and processing the plugins that are returned.
@@ -61,8 +88,10 @@ namespace arbitrator
 
             /**
              * \brief Template function for calling all nodes which respond to a service associated
-             *      with a particular capabilitiy. Will send the service request to all nodes and 
-             *      aggregate the responses.
+             *      with a particular capabilitiy. Will send the service request to all nodes concurrently
+             *      and aggregate the responses received before the plugin call timeout expires.
+             *      Nodes which are still processing a previous request are skipped and counted in
+             *      the skips of their call statistics.
              * 
              * \tparam MSrv The typename of the service message
              * \param query_string The string name of the capability to look for
@@ -72,16 +101,43 @@ namespace arbitrator
             template<typename MSrv>
             std::map<std::string, MSrv> multiplex_service_call_for_capability(std::string query_string, MSrv msg);
 
+            /**
+             * \brief Get the statistics of the plugin calls made since the last reset
+             * \return A map matching plugin topic name -> call statistics for that plugin
+             */
+            std::map<std::string, PluginCallStatistics> get_plugin_call_statistics() const;
+
+            /**
+             * \brief Clear the accumulated plugin call statistics
+             */
+            void reset_plugin_call_statistics();
+
             const static std::string STRATEGIC_PLAN_CAPABILITY;
         protected:
         private:
+            /**
+             * \brief Persistent service client for a plugin topic along with the last call made to it,
+             *      which may still be outstanding if the plugin missed the call timeout
+             */
+            struct PluginClient
+            {
+                ros::ServiceClient client;
+                std::shared_future<void> call;
+            };
+
+            /**
+             * \brief Check if the last call made to a plugin has yet to complete
+             */
+            static bool is_call_in_flight(const PluginClient& plugin_client);
+
             ros::NodeHandle *nh_;
 
             ros::ServiceClient sc_s;
             std::unordered_set <std::string> capabilities_ ; 
 
-
-            
+            ros::WallDuration plugin_call_timeout_;
+            std::map<std::string, PluginClient> plugin_clients_;
+            std::map<std::string, PluginCallStatistics> plugin_call_statistics_;
     };
 };
 
@@ -21,6 +21,12 @@
 #include <map>
 #include <string>
 #include <functional>
+#include <algorithm>
+#include <future>
+#include <chrono>
+#include <tuple>
+#include <utility>
+#include <memory>
 #include <cav_srvs/PlanManeuvers.h>
 
 namespace arbitrator 
@@ -30,11 +36,67 @@ namespace arbitrator
     {
         std::vector<std::string> topics = get_topics_for_capability(query_string);
         std::map<std::string, MSrv> responses;
+
+        // Call every plugin asynchronously. The futures of the calls are kept with the plugin clients so a
+        // call which misses the timeout does not block this function but is still joined on destruction.
+        using CallResult = std::tuple<bool, MSrv, ros::WallDuration>;
+        std::vector<std::pair<std::string, std::shared_ptr<CallResult>>> calls;
         for (auto i = topics.begin(); i != topics.end(); i++) 
         {
-            ros::ServiceClient sc = nh_->serviceClient<cav_srvs::PlanManeuvers>(*i);
-            if (sc.call(msg)) {
-                responses.emplace(*i, msg);
+            auto client_it = plugin_clients_.find(*i);
+            if (client_it == plugin_clients_.end())
+            {
+                PluginClient plugin_client;
+                plugin_client.client = nh_->serviceClient<MSrv>(*i, true);
+                client_it = plugin_clients_.emplace(*i, plugin_client).first;
+            }
+
+            PluginClient &plugin_client = client_it->second;
+            if (is_call_in_flight(plugin_client))
+            {
+                ROS_WARN_STREAM("Skipping plugin " << *i << " as it has not responded to its previous request");
+                plugin_call_statistics_[*i].skips++;
+                continue;
+            }
+
+            ros::ServiceClient sc = plugin_client.client;
+            std::shared_ptr<CallResult> result = std::make_shared<CallResult>();
+            plugin_client.call = std::async(std::launch::async, [sc, msg, result]() mutable
+            {
+                MSrv srv = msg;
+                ros::WallTime call_start = ros::WallTime::now();
+                bool success = sc.call(srv);
+                ros::WallDuration latency = ros::WallTime::now() - call_start;
+                *result = std::make_tuple(success, srv, latency);
+            }).share();
+            calls.emplace_back(*i, result);
+        }
+
+        ros::WallTime deadline = ros::WallTime::now() + plugin_call_timeout_;
+        for (auto it = calls.begin(); it != calls.end(); it++)
+        {
+            PluginCallStatistics &stats = plugin_call_statistics_[it->first];
+            stats.calls++;
+
+            ros::WallDuration remaining = deadline - ros::WallTime::now();
+            std::chrono::nanoseconds wait_time(std::max<int64_t>(remaining.toNSec(), 0));
+            if (plugin_clients_[it->first].call.wait_for(wait_time) != std::future_status::ready)
+            {
+                ROS_WARN_STREAM("Plugin " << it->first << " did not respond within " << plugin_call_timeout_.toSec() << "s and was dropped");
+                stats.timeouts++;
+                continue;
+            }
+
+            CallResult &result = *it->second;
+            double latency_ms = std::get<2>(result).toSec() * 1000.0;
+            stats.total_latency_ms += latency_ms;
+            stats.max_latency_ms = std::max(stats.max_latency_ms, latency_ms);
+            if (std::get<0>(result)) {
+                responses.emplace(it->first, std::move(std::get<1>(result)));
+            } else {
+                stats.failures++;
+                // Recreate the persistent client on the next request in case its connection was dropped
+                plugin_clients_.erase(it->first);
             }
         }
         return responses;
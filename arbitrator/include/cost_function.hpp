@@ -18,7 +18,7 @@
 #define __ARBITRATOR_INCLUDE_COST_FUNCTION_HPP__
 
 #include <cav_msgs/ManeuverPlan.h>
-#include <cav_msgs/ManeuverPlan.h>
+#include <vector>
 
 namespace arbitrator
 {
@@ -43,6 +43,26 @@ namespace arbitrator
              */
             virtual double compute_cost_per_unit_distance(const cav_msgs::ManeuverPlan& plan) = 0;
 
+            /**
+             * \brief Compute the unit cost over distance of a batch of maneuver plans
+             * 
+             * Implementations which can evaluate many plans more cheaply than one at a time
+             * should override this. The default evaluates each plan individually.
+             * 
+             * \param plans The plans to evaluate. Must not contain null pointers
+             * \return The unit cost over distance of each plan in the same order as the input
+             */
+            virtual std::vector<double> compute_costs_per_unit_distance(const std::vector<const cav_msgs::ManeuverPlan*>& plans)
+            {
+                std::vector<double> costs;
+                costs.reserve(plans.size());
+                for (const cav_msgs::ManeuverPlan* plan : plans)
+                {
+                    costs.push_back(compute_cost_per_unit_distance(*plan));
+                }
+                return costs;
+            }
+
             /**
              * \brief Virtual destructor provided for memory safety
              */
@@ -19,8 +19,11 @@
 
 #include <ros/ros.h>
 #include "cost_function.hpp"
+#include <cost_evaluator.hpp>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace arbitrator
 {
@@ -30,6 +33,9 @@ namespace arbitrator
      * Implements costs by utilizing a ROS service call to the CARMA cost plugin
      * system. Passes on the input maneuver plan to the Cost Plugin System for 
      * computation of the actual cost and cost per unit distance.
+     * 
+     * Optionally the cost plugin system library can be run in-process, in which
+     * case plans are evaluated directly without a service round trip.
      */
     class CostSystemCostFunction : public CostFunction
     {
@@ -49,6 +55,15 @@ namespace arbitrator
              */
             void init(ros::NodeHandle &nh);
 
+            /**
+             * Initialize the CostSystemCostFunction to evaluate plans in-process.
+             * The service client is still set up and used for any plan the in-process evaluation fails on.
+             * 
+             * \param nh A publicly namespaced nodehandle
+             * \param config The cost plugin system parameters to evaluate plans with
+             */
+            void init(ros::NodeHandle &nh, const cost_plugin_system::CostEvaluatorConfig& config);
+
             /**
              * \brief Compute the unit cost over distance of a given maneuver plan
              * \param plan The plan to evaluate
@@ -65,8 +80,31 @@ namespace arbitrator
              * \throws std::logic_error if not initialized
              */
             double compute_cost_per_unit_distance(const cav_msgs::ManeuverPlan& plan);
+
+            /**
+             * \brief Compute the unit cost over distance of a batch of maneuver plans.
+             * When evaluating in-process the whole batch is handed to the cost plugin system at once.
+             * \param plans The plans to evaluate
+             * \return The unit cost over distance of each plan in the same order as the input
+             * \throws std::logic_error if not initialized
+             */
+            std::vector<double> compute_costs_per_unit_distance(const std::vector<const cav_msgs::ManeuverPlan*>& plans);
         private:
+            /**
+             * \brief Compute the total cost of a plan with the in-process evaluator, falling back to the
+             * cost plugin system service if the evaluation fails
+             * \return The plan cost, or infinity if the plan could not be evaluated either way
+             */
+            double compute_in_process_cost(const cav_msgs::ManeuverPlan& plan);
+
+            /**
+             * \brief Compute the total cost of a plan with a service call to the cost plugin system
+             * \return The plan cost, or infinity if the service call failed
+             */
+            double compute_service_cost(const cav_msgs::ManeuverPlan& plan);
+
             ros::ServiceClient cost_system_sc_;
+            std::unique_ptr<cost_plugin_system::CostEvaluator> evaluator_;
             bool initialized_ = false;
     };
 };
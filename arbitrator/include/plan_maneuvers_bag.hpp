@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2019-2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#ifndef __ARBITRATOR_INCLUDE_PLAN_MANEUVERS_BAG_HPP__
+#define __ARBITRATOR_INCLUDE_PLAN_MANEUVERS_BAG_HPP__
+
+#include <string>
+#include <vector>
+#include <rosbag/bag.h>
+#include <cav_srvs/PlanManeuvers.h>
+#include <std_msgs/Time.h>
+
+namespace arbitrator
+{
+    /**
+     * \brief A strategic plugin PlanManeuvers request and response as recorded during arbitration
+     */
+    struct RecordedPlanManeuvers
+    {
+        std::string plugin;
+        cav_srvs::PlanManeuvers srv;
+        // True for the first exchange recorded after the start of a planning cycle
+        bool cycle_start = false;
+        // The planning start time recorded with the cycle marker, only set when cycle_start is true
+        ros::Time planning_start;
+    };
+
+    /**
+     * \brief Records the PlanManeuvers exchanges of the arbitrator with its strategic plugins into a bag file
+     * 
+     * Each exchange is written as a cav_srvs/PlanManeuversRequest on <plugin>/request followed
+     * by a cav_srvs/PlanManeuversResponse on <plugin>/response so it can later be replayed
+     * through the arbitrator search with ReplayNeighborGenerator. The start of each planning
+     * cycle is marked by a std_msgs/Time holding the planning start time on planning_cycle.
+     */
+    class PlanManeuversRecorder
+    {
+        public:
+            /**
+             * \brief Constructor, opens the bag file for writing
+             * \param bag_path The path of the bag file to create
+             * \throws rosbag::BagException if the bag cannot be opened
+             */
+            explicit PlanManeuversRecorder(const std::string& bag_path);
+
+            /**
+             * \brief Record a single request and response
+             * \param plugin The service topic of the plugin that responded
+             * \param srv The request sent and the response received
+             */
+            void record(const std::string& plugin, const cav_srvs::PlanManeuvers& srv);
+
+            /**
+             * \brief Record the start of a planning cycle. Exchanges recorded afterwards belong to this cycle
+             * \param planning_start The time at which the arbitrator began the planning cycle
+             */
+            void record_cycle_start(const ros::Time& planning_start);
+        private:
+            /**
+             * \brief Get the stamp for the next bag message, strictly after the previous one so the
+             * bag plays back in recording order
+             */
+            ros::Time next_stamp();
+
+            rosbag::Bag bag_;
+            ros::Time last_stamp_;
+    };
+
+    /**
+     * \brief Read all PlanManeuvers exchanges from a bag written by PlanManeuversRecorder
+     * \param bag_path The path of the bag file to read
+     * \return The recorded exchanges in the order they were recorded
+     * \throws rosbag::BagException if the bag cannot be read
+     */
+    std::vector<RecordedPlanManeuvers> read_plan_maneuvers_bag(const std::string& bag_path);
+};
+
+#endif //__ARBITRATOR_INCLUDE_PLAN_MANEUVERS_BAG_HPP__
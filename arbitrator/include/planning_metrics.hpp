@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2019-2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#ifndef __ARBITRATOR_INCLUDE_PLANNING_METRICS_HPP__
+#define __ARBITRATOR_INCLUDE_PLANNING_METRICS_HPP__
+
+#include <map>
+#include <string>
+#include <ros/ros.h>
+#include <diagnostic_msgs/DiagnosticArray.h>
+#include "planning_strategy.hpp"
+#include "capabilities_interface.hpp"
+
+namespace arbitrator
+{
+    /**
+     * \brief Name of the DiagnosticStatus entry describing the search in a planning metrics message
+     */
+    const std::string PLANNING_METRICS_SEARCH_STATUS = "arbitrator_search";
+
+    /**
+     * \brief Compose the metrics of a single planning cycle into a diagnostics message
+     * 
+     * The first status describes the search (nodes expanded, plans evaluated, depth, 
+     * neighbor generation and cost function time, beam occupancy and total time).
+     * One further status is added for each plugin called during the cycle.
+     * 
+     * \param stats The statistics of the planning cycle
+     * \param plugin_stats The statistics of the plugin calls made during the cycle
+     * \param stamp The time the planning cycle started
+     * \return The planning metrics message
+     */
+    diagnostic_msgs::DiagnosticArray compose_planning_metrics(const PlanningStatistics& stats,
+        const std::map<std::string, PluginCallStatistics>& plugin_stats,
+        const ros::Time& stamp);
+};
+
+#endif //__ARBITRATOR_INCLUDE_PLANNING_METRICS_HPP__
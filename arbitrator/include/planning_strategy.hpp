@@ -17,10 +17,29 @@
 #ifndef __ARBITRATOR_INCLUDE_PLANNING_STRATEGY_HPP__
 #define __ARBITRATOR_INCLUDE_PLANNING_STRATEGY_HPP__
 
+#include <vector>
+#include <ros/ros.h>
 #include <cav_msgs/ManeuverPlan.h>
 
 namespace arbitrator
 {
+    /**
+     * \brief Statistics describing the search performed by a PlanningStrategy
+     *      during a single planning cycle
+     */
+    struct PlanningStatistics
+    {
+        uint32_t nodes_expanded = 0;
+        uint32_t plans_evaluated = 0;
+        uint32_t search_depth = 0;
+        bool deadline_reached = false;
+        ros::WallDuration planning_time;
+        ros::WallDuration neighbor_generation_time; // Time spent generating children, including plugin calls
+        ros::WallDuration cost_function_time; // Time spent computing plan costs
+        std::vector<uint32_t> open_list_sizes; // Number of plans kept in the open list after each search depth
+        uint32_t reused_maneuvers = 0; // Number of unexpired prior plan maneuvers the search was seeded with
+    };
+
     /**
      * \brief Generic interface representing a strategy for arriving at a maneuver
      * plan
@@ -34,6 +53,34 @@ namespace arbitrator
              */
             virtual cav_msgs::ManeuverPlan generate_plan() = 0;
 
+            /**
+             * \brief Generate a plausible maneuver plan, stopping at the deadline
+             *      with the best plan found so far. The default implementation
+             *      ignores the deadline.
+             * \param deadline The wall-clock time by which a plan must be returned
+             * \return A maneuver plan from the vehicle's current state
+             */
+            virtual cav_msgs::ManeuverPlan generate_plan(const ros::WallTime& deadline)
+            {
+                return generate_plan();
+            }
+
+            /**
+             * \brief Provide the previously published plan so the next call to generate_plan
+             *      may reuse its unexpired maneuvers. The default implementation ignores it.
+             * \param plan The most recently published plan
+             */
+            virtual void set_prior_plan(const cav_msgs::ManeuverPlan& plan) {}
+
+            /**
+             * \brief Get the statistics of the most recent call to generate_plan
+             * \return The statistics, zeroed if the strategy does not track them
+             */
+            virtual PlanningStatistics get_last_planning_statistics() const
+            {
+                return PlanningStatistics();
+            }
+
             /**
              * \brief Virtual destructor provided for memory safety
              */
@@ -17,6 +17,9 @@
 #ifndef __ARBITRATOR_INCLUDE_PLUGIN_NEIGHBOR_GENERATOR_HPP__
 #define __ARBITRATOR_INCLUDE_PLUGIN_NEIGHBOR_GENERATOR_HPP__
 
+#include <functional>
+#include <string>
+#include <cav_srvs/PlanManeuvers.h>
 #include "neighbor_generator.hpp"
 #include "capabilities_interface.hpp"
 
@@ -49,8 +52,23 @@ namespace arbitrator
              * \return A list of subsequent plans building on top of the input plan
              */
             std::vector<cav_msgs::ManeuverPlan> generate_neighbors(cav_msgs::ManeuverPlan plan) const;
+
+            /**
+             * Callback invoked with the plugin topic and the request/response of every plugin response received
+             */
+            using ResponseObserver = std::function<void(const std::string&, const cav_srvs::PlanManeuvers&)>;
+
+            /**
+             * Set a callback to be notified of every plugin response, such as a PlanManeuversRecorder
+             * \param observer The callback, or an empty function to stop notifying
+             */
+            void set_response_observer(ResponseObserver observer)
+            {
+                response_observer_ = observer;
+            }
         private:
             T &ci_;
+            ResponseObserver response_observer_;
     };
 };
 
@@ -35,6 +35,10 @@ namespace arbitrator
         std::vector<cav_msgs::ManeuverPlan> out;
         for (auto it = res.begin(); it != res.end(); it++)
         {
+            if (response_observer_)
+            {
+                response_observer_(it->first, it->second);
+            }
             out.push_back(it->second.response.new_plan);
         }
         return out;
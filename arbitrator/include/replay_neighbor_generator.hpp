@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2019-2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#ifndef __ARBITRATOR_INCLUDE_REPLAY_NEIGHBOR_GENERATOR_HPP__
+#define __ARBITRATOR_INCLUDE_REPLAY_NEIGHBOR_GENERATOR_HPP__
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "neighbor_generator.hpp"
+#include "plan_maneuvers_bag.hpp"
+
+namespace arbitrator
+{
+    /**
+     * \brief Implementation of the NeighborGenerator interface which replays recorded plugin responses
+     * 
+     * Allows the arbitrator search to be run offline against the PlanManeuvers responses
+     * strategic plugins gave during a drive. The recording is split into planning cycles at the
+     * cycle markers written by PlanManeuversRecorder::record_cycle_start. Recordings without
+     * markers are split at the first request for the empty root plan after any other plan has
+     * been expanded, which only works when the arbitrator did not warm start from its prior plan.
+     * The first plan expanded in each cycle is its root, which is the seed of a warm started search.
+     * Plans which were never expanded during recording have no neighbors.
+     */
+    class ReplayNeighborGenerator : public NeighborGenerator
+    {
+        public:
+            /**
+             * \brief Constructor
+             * \param records The recorded plugin requests and responses, in recording order
+             */
+            explicit ReplayNeighborGenerator(const std::vector<RecordedPlanManeuvers>& records);
+
+            /**
+             * \brief Get the number of planning cycles in the recording
+             */
+            size_t get_cycle_count() const;
+
+            /**
+             * \brief Select the planning cycle whose responses are replayed
+             * \param cycle The index of the cycle, must be less than get_cycle_count()
+             * \throws std::out_of_range if cycle is not a recorded cycle
+             */
+            void set_cycle(size_t cycle);
+
+            /**
+             * \brief Get the plan the search of the current cycle started from
+             * \return The seeded prior plan if the arbitrator warm started the cycle, otherwise an empty plan
+             */
+            const cav_msgs::ManeuverPlan& get_cycle_root() const;
+
+            /**
+             * \brief Get the planning start time of the current cycle
+             * \return The time recorded with the cycle marker, or zero for recordings without markers
+             */
+            ros::Time get_cycle_planning_start() const;
+
+            /**
+             * \brief Return the plans recorded in the current cycle in response to the given plan
+             * \param plan The maneuver plan to expand upon
+             * \return The recorded responses, in the order they were recorded
+             */
+            std::vector<cav_msgs::ManeuverPlan> generate_neighbors(cav_msgs::ManeuverPlan plan) const;
+        private:
+            // Maneuver sequence key of the prior plan -> plans returned by the plugins
+            using ResponseTable = std::unordered_map<std::string, std::vector<cav_msgs::ManeuverPlan>>;
+            struct ReplayCycle
+            {
+                ResponseTable responses;
+                cav_msgs::ManeuverPlan root;
+                ros::Time planning_start;
+            };
+            std::vector<ReplayCycle> cycles_;
+            size_t current_cycle_ = 0;
+    };
+};
+
+#endif //__ARBITRATOR_INCLUDE_REPLAY_NEIGHBOR_GENERATOR_HPP__
@@ -18,6 +18,8 @@
 #define __ARBITRATOR_INCLUDE_TREE_PLANNER_HPP__
 
 #include <memory>
+#include <string>
+#include <boost/optional.hpp>
 #include <cav_msgs/ManeuverPlan.h>
 #include "planning_strategy.hpp"
 #include "cost_function.hpp"
@@ -44,26 +46,71 @@ namespace arbitrator
              * \param ng A reference to a NeighborGenerator implementation
              * \param ss A reference to a SearchStrategy implementation
              * \param target The desired duration of finished plans
+             * \param reuse When a search is seeded with a prior plan whose unexpired maneuvers 
+             *      still cover at least this duration, those maneuvers are returned without any
+             *      expansion. Zero disables reuse without expansion.
              */
             TreePlanner(CostFunction &cf, 
                 NeighborGenerator &ng, 
                 SearchStrategy &ss, 
-                ros::Duration target):
+                ros::Duration target,
+                ros::Duration reuse = ros::Duration(0)):
                 cost_function_(cf),
                 neighbor_generator_(ng),
                 search_strategy_(ss),
-                target_plan_duration_(target) {};
+                target_plan_duration_(target),
+                prior_plan_reuse_duration_(reuse) {};
 
             /**
              * \brief Utilize the configured cost function, neighbor generator, 
              *      and search strategy, to generate a plan by means of tree search
              */
             cav_msgs::ManeuverPlan generate_plan();
+
+            /**
+             * \brief Utilize the configured cost function, neighbor generator, 
+             *      and search strategy, to generate a plan by means of tree search.
+             *      If the deadline is reached before a plan of the target duration
+             *      is found, the longest plan found so far is returned.
+             * \param deadline The wall-clock time at which the search stops
+             */
+            cav_msgs::ManeuverPlan generate_plan(const ros::WallTime& deadline);
+
+            /**
+             * \brief Seed the next search with the unexpired maneuvers of a prior plan.
+             *      The search then only expands beyond those maneuvers, and plugins
+             *      receive them as the prior plan to extend. The seed is used for a
+             *      single search only.
+             * \param plan The most recently published plan
+             */
+            void set_prior_plan(const cav_msgs::ManeuverPlan& plan);
+
+            /**
+             * \brief Get the statistics of the most recent search
+             */
+            PlanningStatistics get_last_planning_statistics() const;
         protected:
+            /**
+             * \brief Build a key identifying the maneuver sequence of a plan for use in the
+             *      planner's transposition tables. Other plan fields such as the ID are ignored.
+             * \param plan The plan to build the key for
+             * \return The serialized maneuvers of the plan
+             */
+            std::string maneuver_sequence_key(const cav_msgs::ManeuverPlan& plan) const;
+
+            /**
+             * \brief Perform the tree search, updating last_statistics_ as it progresses
+             * \param deadline The optional wall-clock time at which the search stops
+             */
+            cav_msgs::ManeuverPlan search(const boost::optional<ros::WallTime>& deadline);
+
             CostFunction &cost_function_;
             NeighborGenerator &neighbor_generator_;
             SearchStrategy &search_strategy_;
             ros::Duration target_plan_duration_;
+            ros::Duration prior_plan_reuse_duration_;
+            cav_msgs::ManeuverPlan prior_plan_;
+            PlanningStatistics last_statistics_;
     };
 };
 
@@ -18,9 +18,14 @@
 #include <cav_msgs/ManeuverPlan.h>
 #include <cav_srvs/PlanManeuvers.h>
 #include "arbitrator_utils.hpp"
+#include "planning_metrics.hpp"
 #include <ros/ros.h>
+#include <ros/callback_queue.h>
 #include <exception>
 #include <cstdlib>
+#include <algorithm>
+#include <boost/uuid/uuid_generators.hpp>
+#include <boost/uuid/uuid_io.hpp>
 
 namespace arbitrator
 {
@@ -92,28 +97,92 @@ namespace arbitrator
         }
     }
 
+    void Arbitrator::replan_trigger_cb(const topic_tools::ShapeShifter::ConstPtr& msg)
+    {
+        ROS_DEBUG_STREAM("Arbitrator received " << msg->getDataType() << " input change, requesting replan.");
+        replan_requested_ = true;
+    }
+
+    ros::Time Arbitrator::get_next_planning_start() const
+    {
+        if (replan_requested_)
+        {
+            return std::min(next_planning_process_start_, last_planning_process_start_ + min_replan_interval_);
+        }
+        return next_planning_process_start_;
+    }
+
+    void Arbitrator::wait_for_callbacks(const ros::Duration& timeout)
+    {
+        // Returns as soon as a callback has been handled, so events are not delayed by the timeout
+        ros::getGlobalCallbackQueue()->callAvailable(ros::WallDuration(std::max(timeout.toSec(), 0.0)));
+    }
+
     void Arbitrator::initial_state()
     {
         if(!initialized_)
         {   
             ROS_INFO("Arbitrator initializing on first initial state spin...");
             final_plan_pub_ = nh_->advertise<cav_msgs::ManeuverPlan>("final_maneuver_plan", 5);
+            planning_metrics_pub_ = pnh_->advertise<diagnostic_msgs::DiagnosticArray>("planning_metrics", 5);
             guidance_state_sub_ = nh_->subscribe<cav_msgs::GuidanceState>("guidance_state", 5, &Arbitrator::guidance_state_cb, this);
+            pnh_->param("use_anytime_planning", use_anytime_planning_, false);
+            pnh_->param("planning_deadline_ratio", planning_deadline_ratio_, 0.8);
+            pnh_->param("use_warm_start", use_warm_start_, false);
+            std::vector<std::string> replan_trigger_topics;
+            pnh_->param("replan_trigger_topics", replan_trigger_topics, std::vector<std::string>());
+            for (const std::string& topic : replan_trigger_topics)
+            {
+                replan_trigger_subs_.push_back(nh_->subscribe<topic_tools::ShapeShifter>(topic, 1, &Arbitrator::replan_trigger_cb, this));
+            }
             initialized_ = true;
             // TODO: load plan duration from parameters file
+            return;
         }
+        wait_for_callbacks(IDLE_CALLBACK_TIMEOUT);
     }
 
     void Arbitrator::planning_state()
     {
         ROS_INFO("Aribtrator beginning planning process!");
         ros::Time planning_process_start = ros::Time::now();
-        cav_msgs::ManeuverPlan plan = planning_strategy_.generate_plan();
+        // An input change may invalidate the previous plan, so only reuse it when replanning on schedule
+        if (use_warm_start_ && !replan_requested_)
+        {
+            planning_strategy_.set_prior_plan(last_published_plan_);
+        }
+        // Inputs which change from here on are not guaranteed to be seen by this plan and request another
+        replan_requested_ = false;
+        last_planning_process_start_ = planning_process_start;
+        if (planning_cycle_observer_)
+        {
+            planning_cycle_observer_(planning_process_start);
+        }
+        cav_msgs::ManeuverPlan plan;
+        capabilities_interface_->reset_plugin_call_statistics();
+        if (use_anytime_planning_)
+        {
+            // Leave the remainder of the planning period for publication and downstream processing
+            ros::WallTime deadline = ros::WallTime::now() + ros::WallDuration(time_between_plans_.toSec() * planning_deadline_ratio_);
+            plan = planning_strategy_.generate_plan(deadline);
+        }
+        else
+        {
+            plan = planning_strategy_.generate_plan();
+        }
+
+        PlanningStatistics stats = planning_strategy_.get_last_planning_statistics();
+        ROS_INFO_STREAM("Arbitrator search expanded " << stats.nodes_expanded << " nodes and evaluated " << stats.plans_evaluated 
+            << " plans to depth " << stats.search_depth << " in " << stats.planning_time.toSec() << "s" 
+            << (stats.deadline_reached ? ", stopped at planning deadline" : ""));
+        planning_metrics_pub_.publish(compose_planning_metrics(stats, capabilities_interface_->get_plugin_call_statistics(), planning_process_start));
         if (!plan.maneuvers.empty()) 
         {
             ros::Time plan_end_time = arbitrator_utils::get_plan_end_time(plan);
             ros::Time plan_start_time = arbitrator_utils::get_plan_start_time(plan);
             ros::Duration plan_duration = plan_end_time - plan_start_time;
+            // A warm started plan shares maneuvers with the previous one but is still a new plan
+            plan.maneuver_plan_id = boost::uuids::to_string(boost::uuids::random_generator()());
 
             if (plan_duration < min_plan_duration_) 
             {
@@ -124,6 +193,7 @@ namespace arbitrator
                 ROS_INFO_STREAM("Arbitrator is publishing plan " << plan.maneuver_plan_id << " of duration " << plan_duration << " as current maneuver plan");
             }
             final_plan_pub_.publish(plan);
+            last_published_plan_ = plan;
         }
         else
         {
@@ -137,19 +207,26 @@ namespace arbitrator
 
     void Arbitrator::waiting_state()
     {
-        // Sleep in 100ms increments until our next planning cycle
-        // This ensures we spin() at least a few times
-        while (ros::Time::now() < next_planning_process_start_)
+        // Handle callbacks as they arrive until the next planning cycle is due. A replan trigger
+        // received meanwhile moves the next cycle forward, subject to the replan rate limit
+        while (!ros::isShuttingDown() && sm_->get_state() == ArbitratorState::WAITING)
         {
-            ros::Duration(0.1).sleep();
+            ros::Time now = ros::Time::now();
+            ros::Time next_planning_start = get_next_planning_start();
+            if (now >= next_planning_start)
+            {
+                ROS_INFO_STREAM("Arbitrator transitioning from WAITING to PLANNING state" << (replan_requested_ ? " on replan trigger." : "."));
+                sm_->submit_event(ArbitratorEvent::PLANNING_TIMER_TRIGGER);
+                return;
+            }
+            wait_for_callbacks(std::min(next_planning_start - now, IDLE_CALLBACK_TIMEOUT));
         }
-        ROS_INFO("Arbitrator transitioning from WAITING to PLANNING state.");
-        sm_->submit_event(ArbitratorEvent::PLANNING_TIMER_TRIGGER);
     }
 
     void Arbitrator::paused_state()
     {
-        ros::Duration(0.1).sleep();
+        // Guidance state updates resume the arbitrator from within the callbacks
+        wait_for_callbacks(IDLE_CALLBACK_TIMEOUT);
     }
 
     void Arbitrator::shutdown_state()
@@ -24,6 +24,7 @@
 #include "plugin_neighbor_generator.hpp"
 #include "beam_search_strategy.hpp"
 #include "tree_planner.hpp"
+#include "plan_maneuvers_bag.hpp"
 
 int main(int argc, char** argv) 
 {
@@ -31,8 +32,11 @@ int main(int argc, char** argv)
     ros::CARMANodeHandle nh = ros::CARMANodeHandle();
     ros::CARMANodeHandle pnh = ros::CARMANodeHandle("~");
 
+    double plugin_call_timeout;
+    pnh.param("plugin_call_timeout", plugin_call_timeout, 0.5);
+
     // Handle dependency injection
-    arbitrator::CapabilitiesInterface ci{&nh};
+    arbitrator::CapabilitiesInterface ci{&nh, ros::WallDuration(plugin_call_timeout)};
     arbitrator::ArbitratorStateMachine sm;
 
     bool use_fixed_costs = false; 
@@ -46,7 +50,14 @@ int main(int argc, char** argv)
     if (use_fixed_costs) {
         cf = &fpcf;
     } else {
-        cscf.init(nh);
+        bool use_in_process_costs = true;
+        pnh.getParam("use_in_process_costs", use_in_process_costs);
+        if (use_in_process_costs) {
+            ros::NodeHandle cost_nh(pnh, "cost_plugin_system");
+            cscf.init(nh, cost_plugin_system::CostEvaluator::loadConfig(cost_nh));
+        } else {
+            cscf.init(nh);
+        }
         cf = &cscf;
     }
 
@@ -56,15 +67,32 @@ int main(int argc, char** argv)
 
     arbitrator::PluginNeighborGenerator<arbitrator::CapabilitiesInterface> png{ci};
 
+    std::string plugin_response_bag;
+    pnh.param<std::string>("plugin_response_bag", plugin_response_bag, "");
+    std::unique_ptr<arbitrator::PlanManeuversRecorder> recorder;
+    if (!plugin_response_bag.empty()) {
+        ROS_INFO_STREAM("Arbitrator recording strategic plugin responses to " << plugin_response_bag);
+        recorder.reset(new arbitrator::PlanManeuversRecorder(plugin_response_bag));
+        arbitrator::PlanManeuversRecorder* recorder_ptr = recorder.get();
+        png.set_response_observer([recorder_ptr](const std::string& plugin, const cav_srvs::PlanManeuvers& srv) {
+            recorder_ptr->record(plugin, srv);
+        });
+    }
+
     double target_plan;
     pnh.param("target_plan_duration", target_plan, 15.0);
-    arbitrator::TreePlanner tp{*cf, png, bss, ros::Duration(target_plan)};
+    double prior_plan_reuse_duration;
+    pnh.param("prior_plan_reuse_duration", prior_plan_reuse_duration, 0.0);
+    arbitrator::TreePlanner tp{*cf, png, bss, ros::Duration(target_plan), ros::Duration(prior_plan_reuse_duration)};
 
     double min_plan_duration;
     pnh.param("min_plan_duration", min_plan_duration, 6.0);
 
     double planning_frequency;
     pnh.param("planning_frequency", planning_frequency, 1.0);
+
+    double min_replan_interval;
+    pnh.param("min_replan_interval", min_replan_interval, 0.2);
     arbitrator::Arbitrator arbitrator{
         &nh, 
         &pnh, 
@@ -72,7 +100,15 @@ int main(int argc, char** argv)
         &ci, 
         tp, 
         ros::Duration(min_plan_duration),
-        ros::Rate(planning_frequency)};
+        ros::Rate(planning_frequency),
+        ros::Duration(min_replan_interval)};
+
+    if (recorder) {
+        arbitrator::PlanManeuversRecorder* recorder_ptr = recorder.get();
+        arbitrator.set_planning_cycle_observer([recorder_ptr](const ros::Time& planning_start) {
+            recorder_ptr->record_cycle_start(planning_start);
+        });
+    }
 
     arbitrator.run();
 
@@ -15,22 +15,44 @@
  */
 
 #include "arbitrator_utils.hpp"
+#include "cost_utils.hpp"
 #include <cav_msgs/Maneuver.h>
+#include <ros/serialization.h>
 #include <exception>
+#include <stdexcept>
+
+/**
+ * \brief Expands to a switch case returning the given field of the maneuver type described by a COST_UTILS_MANEUVER_TYPES row
+ */
+#define ARBITRATOR_RETURN_FIELD_CASE(type_id, member, starting_lane_field, ending_lane_field, field)\
+        case cav_msgs::Maneuver::type_id: return mvr.member.field;
+
+/**
+ * \brief Defines an accessor which returns the given field of a maneuver by dispatching over every row of COST_UTILS_MANEUVER_TYPES,
+ * the maneuver type table shared with cost_plugin_system
+ */
+#define ARBITRATOR_DEFINE_MANEUVER_ACCESSOR(return_type, name, case_macro, field)\
+        return_type name(const cav_msgs::Maneuver &mvr)\
+        {\
+            switch (mvr.type)\
+            {\
+                COST_UTILS_MANEUVER_TYPES(case_macro, field)\
+                default: break;\
+            }\
+            throw std::invalid_argument("arbitrator::" #name " called on maneuver with invalid type id");\
+        }
 
 
 namespace arbitrator_utils
 {
-    ros::Time get_plan_end_time(const cav_msgs::ManeuverPlan &plan) 
+    const ros::Time& get_plan_end_time(const cav_msgs::ManeuverPlan &plan) 
     {
         if (plan.maneuvers.empty())
         {
             throw std::invalid_argument("arbitrator::get_plan_end_time called on empty maneuver plan");
         }
 
-        cav_msgs::Maneuver m = plan.maneuvers.back();
-
-        return get_maneuver_end_time(m);
+        return get_maneuver_end_time(plan.maneuvers.back());
     }
 
     double get_plan_end_distance(const cav_msgs::ManeuverPlan &plan)
@@ -40,19 +62,17 @@ namespace arbitrator_utils
             throw std::invalid_argument("arbitrator::get_plan_end_dist called on empty maneuver plan");
         }
 
-        cav_msgs::Maneuver m = plan.maneuvers.back();
-        return get_maneuver_end_distance(m);
+        return get_maneuver_end_distance(plan.maneuvers.back());
     }
 
-    ros::Time get_plan_start_time(const cav_msgs::ManeuverPlan &plan) 
+    const ros::Time& get_plan_start_time(const cav_msgs::ManeuverPlan &plan) 
     {
         if (plan.maneuvers.empty())
         {
             throw std::invalid_argument("arbitrator::get_plan_start_time called on empty maneuver plan");
         }
 
-        cav_msgs::Maneuver m = plan.maneuvers.front();
-        return get_maneuver_start_time(m);
+        return get_maneuver_start_time(plan.maneuvers.front());
     }
 
     double get_plan_start_distance(const cav_msgs::ManeuverPlan &plan)
@@ -62,27 +82,42 @@ namespace arbitrator_utils
             throw std::invalid_argument("arbitrator::get_plan_start_dist called on empty maneuver plan");
         }
 
-        cav_msgs::Maneuver m = plan.maneuvers.front();
-        return get_maneuver_start_distance(m);
+        return get_maneuver_start_distance(plan.maneuvers.front());
     }
 
-    ros::Time get_maneuver_end_time(const cav_msgs::Maneuver &mvr) 
-    {
-        return GET_MANEUVER_PROPERTY(mvr, end_time);
-    }
+    ARBITRATOR_DEFINE_MANEUVER_ACCESSOR(const ros::Time&, get_maneuver_end_time, ARBITRATOR_RETURN_FIELD_CASE, end_time)
 
-    ros::Time get_maneuver_start_time(const cav_msgs::Maneuver &mvr) 
-    {
-        return GET_MANEUVER_PROPERTY(mvr, start_time);
-    }
+    ARBITRATOR_DEFINE_MANEUVER_ACCESSOR(const ros::Time&, get_maneuver_start_time, ARBITRATOR_RETURN_FIELD_CASE, start_time)
+
+    ARBITRATOR_DEFINE_MANEUVER_ACCESSOR(double, get_maneuver_end_distance, ARBITRATOR_RETURN_FIELD_CASE, end_dist)
+
+    ARBITRATOR_DEFINE_MANEUVER_ACCESSOR(double, get_maneuver_start_distance, ARBITRATOR_RETURN_FIELD_CASE, start_dist)
 
-    double get_maneuver_end_distance(const cav_msgs::Maneuver &mvr) 
+    ARBITRATOR_DEFINE_MANEUVER_ACCESSOR(const cav_msgs::ManeuverParameters&, get_maneuver_parameters, ARBITRATOR_RETURN_FIELD_CASE, parameters)
+
+    std::string get_maneuver_sequence_key(const cav_msgs::ManeuverPlan &plan)
     {
-        return GET_MANEUVER_PROPERTY(mvr, end_dist);
+        namespace ser = ros::serialization;
+        uint32_t length = ser::serializationLength(plan.maneuvers);
+        std::string key(length, '\0');
+        ser::OStream stream(reinterpret_cast<uint8_t*>(&key[0]), length);
+        ser::serialize(stream, plan.maneuvers);
+        return key;
     }
 
-    double get_maneuver_start_distance(const cav_msgs::Maneuver &mvr) 
+    cav_msgs::ManeuverPlan get_unexpired_plan(const cav_msgs::ManeuverPlan &plan, const ros::Time &time)
     {
-        return GET_MANEUVER_PROPERTY(mvr, start_dist);
+        cav_msgs::ManeuverPlan unexpired;
+        unexpired.header = plan.header;
+        unexpired.planning_start_time = plan.planning_start_time;
+        unexpired.planning_completion_time = plan.planning_completion_time;
+
+        auto first_unexpired = plan.maneuvers.begin();
+        while (first_unexpired != plan.maneuvers.end() && get_maneuver_end_time(*first_unexpired) <= time)
+        {
+            first_unexpired++;
+        }
+        unexpired.maneuvers.assign(first_unexpired, plan.maneuvers.end());
+        return unexpired;
     }
 } // namespace arbitrator_utils
@@ -15,23 +15,26 @@
  */
 
 #include "beam_search_strategy.hpp"
+#include <algorithm>
 
 namespace arbitrator
 {
     std::vector<std::pair<cav_msgs::ManeuverPlan, double>> BeamSearchStrategy::prioritize_plans(std::vector<std::pair<cav_msgs::ManeuverPlan, double>> plans) const
     {
-        std::sort(plans.begin(), 
-            plans.end(), 
-            [] (const std::pair<cav_msgs::ManeuverPlan, double>& a, const std::pair<cav_msgs::ManeuverPlan, double>& b) 
-            {
-                return a.second < b.second;
-            }
-        );
+        auto lower_cost = [] (const std::pair<cav_msgs::ManeuverPlan, double>& a, const std::pair<cav_msgs::ManeuverPlan, double>& b) 
+        {
+            return a.second < b.second;
+        };
 
-        if (plans.size() > beam_width_)
+        // Partition the beam from the rest of the plans in linear time so only the plans
+        // which are kept need to be sorted
+        if (beam_width_ >= 0 && plans.size() > static_cast<size_t>(beam_width_))
         {
-            plans.resize(beam_width_);
+            std::nth_element(plans.begin(), plans.begin() + beam_width_, plans.end(), lower_cost);
+            plans.erase(plans.begin() + beam_width_, plans.end());
         }
+
+        std::sort(plans.begin(), plans.end(), lower_cost);
         
         return plans;
     }
@@ -17,10 +17,30 @@
 #include "capabilities_interface.hpp"
 #include <cav_srvs/PlanManeuvers.h>
 #include <exception>
+#include <chrono>
 
 namespace arbitrator
 {
     const std::string CapabilitiesInterface::STRATEGIC_PLAN_CAPABILITY = "strategic_plan/plan_maneuvers";
+
+    CapabilitiesInterface::~CapabilitiesInterface()
+    {
+        for (auto it = plugin_clients_.begin(); it != plugin_clients_.end(); it++)
+        {
+            if (is_call_in_flight(it->second))
+            {
+                // Dropping the persistent connection fails the outstanding call instead of waiting on the plugin
+                it->second.client.shutdown();
+                it->second.call.wait();
+            }
+        }
+    }
+
+    bool CapabilitiesInterface::is_call_in_flight(const PluginClient& plugin_client)
+    {
+        return plugin_client.call.valid() && 
+            plugin_client.call.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+    }
     
     std::vector<std::string> CapabilitiesInterface::get_topics_for_capability(const std::string& query_string)
     {
@@ -38,4 +58,14 @@ namespace arbitrator
         return topics;
 
     }
+
+    std::map<std::string, PluginCallStatistics> CapabilitiesInterface::get_plugin_call_statistics() const
+    {
+        return plugin_call_statistics_;
+    }
+
+    void CapabilitiesInterface::reset_plugin_call_statistics()
+    {
+        plugin_call_statistics_.clear();
+    }
 }
@@ -19,6 +19,7 @@
 #include "cav_srvs/ComputePlanCost.h"
 #include "cav_msgs/ManeuverParameters.h"
 #include <limits>
+#include <stdexcept>
 
 namespace arbitrator
 {
@@ -28,12 +29,24 @@ namespace arbitrator
         initialized_ = true;
     }
 
-    double CostSystemCostFunction::compute_total_cost(const cav_msgs::ManeuverPlan& plan)
+    void CostSystemCostFunction::init(ros::NodeHandle &nh, const cost_plugin_system::CostEvaluatorConfig& config)
     {
-        if (!initialized_) {
-            throw std::logic_error("Attempt to use CostSystemCostFunction before initialization.");
+        init(nh);
+        evaluator_.reset(new cost_plugin_system::CostEvaluator(config));
+    }
+
+    double CostSystemCostFunction::compute_in_process_cost(const cav_msgs::ManeuverPlan& plan)
+    {
+        try {
+            return evaluator_->compute_cost(plan);
+        } catch (const std::exception& e) {
+            ROS_WARN_STREAM("Unable to get cost for plan from in-process CostPluginSystem, falling back to the service: " << e.what());
+            return compute_service_cost(plan);
         }
+    }
 
+    double CostSystemCostFunction::compute_service_cost(const cav_msgs::ManeuverPlan& plan)
+    {
         double total_cost = std::numeric_limits<double>::infinity();
 
         cav_srvs::ComputePlanCost service_message;
@@ -48,10 +61,53 @@ namespace arbitrator
         return total_cost;
     }
 
+    double CostSystemCostFunction::compute_total_cost(const cav_msgs::ManeuverPlan& plan)
+    {
+        if (!initialized_) {
+            throw std::logic_error("Attempt to use CostSystemCostFunction before initialization.");
+        }
+
+        if (evaluator_) {
+            return compute_in_process_cost(plan);
+        }
+
+        return compute_service_cost(plan);
+    }
+
     double CostSystemCostFunction::compute_cost_per_unit_distance(const cav_msgs::ManeuverPlan& plan)
     {
         double plan_dist = arbitrator_utils::get_plan_end_distance(plan) - arbitrator_utils::get_plan_start_distance(plan);
         return compute_total_cost(plan) / plan_dist;
     }
-}
 
+    std::vector<double> CostSystemCostFunction::compute_costs_per_unit_distance(const std::vector<const cav_msgs::ManeuverPlan*>& plans)
+    {
+        if (!initialized_) {
+            throw std::logic_error("Attempt to use CostSystemCostFunction before initialization.");
+        }
+
+        if (!evaluator_) {
+            return CostFunction::compute_costs_per_unit_distance(plans);
+        }
+
+        std::vector<double> costs;
+        try {
+            costs = evaluator_->compute_costs(plans);
+        } catch (const std::exception&) {
+            // Fall back to evaluating plans individually so one malformed plan does not invalidate the batch
+            costs.clear();
+            for (const cav_msgs::ManeuverPlan* plan : plans)
+            {
+                costs.push_back(compute_in_process_cost(*plan));
+            }
+        }
+
+        for (size_t i = 0; i < plans.size(); i++)
+        {
+            double plan_dist = arbitrator_utils::get_plan_end_distance(*plans[i]) - arbitrator_utils::get_plan_start_distance(*plans[i]);
+            costs[i] /= plan_dist;
+        }
+
+        return costs;
+    }
+}
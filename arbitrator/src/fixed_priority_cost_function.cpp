@@ -45,7 +45,7 @@ namespace arbitrator
         double total_cost = 0.0;
         for (auto it = plan.maneuvers.begin(); it != plan.maneuvers.end(); it++)
         {
-            std::string planning_plugin = GET_MANEUVER_PROPERTY(*it, parameters).planning_strategic_plugin;
+            const std::string& planning_plugin = arbitrator_utils::get_maneuver_parameters(*it).planning_strategic_plugin;
             total_cost += (arbitrator_utils::get_maneuver_end_distance(*it) - arbitrator_utils::get_maneuver_start_distance(*it)) *
                 plugin_costs_.at(planning_plugin);
         }
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2019-2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include "plan_maneuvers_bag.hpp"
+#include <map>
+#include <rosbag/view.h>
+
+namespace arbitrator
+{
+    namespace
+    {
+        const std::string REQUEST_SUFFIX = "/request";
+        const std::string RESPONSE_SUFFIX = "/response";
+        const std::string CYCLE_TOPIC = "planning_cycle";
+
+        /**
+         * \brief Check if topic ends with suffix and if so strip it off into plugin
+         */
+        bool strip_suffix(const std::string& topic, const std::string& suffix, std::string& plugin)
+        {
+            if (topic.size() <= suffix.size() || topic.compare(topic.size() - suffix.size(), suffix.size(), suffix) != 0)
+            {
+                return false;
+            }
+            plugin = topic.substr(0, topic.size() - suffix.size());
+            return true;
+        }
+    }
+
+    PlanManeuversRecorder::PlanManeuversRecorder(const std::string& bag_path)
+    {
+        bag_.open(bag_path, rosbag::bagmode::Write);
+    }
+
+    ros::Time PlanManeuversRecorder::next_stamp()
+    {
+        // Wall time is used so recording also works while sim time is still zero
+        ros::Time stamp(ros::WallTime::now().toSec());
+        if (stamp <= last_stamp_)
+        {
+            stamp = last_stamp_ + ros::Duration(0, 1);
+        }
+        last_stamp_ = stamp;
+        return stamp;
+    }
+
+    void PlanManeuversRecorder::record(const std::string& plugin, const cav_srvs::PlanManeuvers& srv)
+    {
+        bag_.write(plugin + REQUEST_SUFFIX, next_stamp(), srv.request);
+        bag_.write(plugin + RESPONSE_SUFFIX, next_stamp(), srv.response);
+    }
+
+    void PlanManeuversRecorder::record_cycle_start(const ros::Time& planning_start)
+    {
+        std_msgs::Time msg;
+        msg.data = planning_start;
+        bag_.write(CYCLE_TOPIC, next_stamp(), msg);
+    }
+
+    std::vector<RecordedPlanManeuvers> read_plan_maneuvers_bag(const std::string& bag_path)
+    {
+        rosbag::Bag bag(bag_path, rosbag::bagmode::Read);
+        rosbag::View view(bag);
+
+        std::vector<RecordedPlanManeuvers> records;
+        std::map<std::string, cav_srvs::PlanManeuversRequest> pending_requests;
+        bool cycle_started = false;
+        ros::Time planning_start;
+        for (const rosbag::MessageInstance& m : view)
+        {
+            std::string plugin;
+            if (m.getTopic() == CYCLE_TOPIC)
+            {
+                std_msgs::Time::ConstPtr cycle = m.instantiate<std_msgs::Time>();
+                planning_start = cycle ? cycle->data : ros::Time();
+                cycle_started = true;
+                pending_requests.clear();
+            }
+            else if (strip_suffix(m.getTopic(), REQUEST_SUFFIX, plugin))
+            {
+                cav_srvs::PlanManeuversRequest::ConstPtr req = m.instantiate<cav_srvs::PlanManeuversRequest>();
+                if (req)
+                {
+                    pending_requests[plugin] = *req;
+                }
+            }
+            else if (strip_suffix(m.getTopic(), RESPONSE_SUFFIX, plugin))
+            {
+                cav_srvs::PlanManeuversResponse::ConstPtr res = m.instantiate<cav_srvs::PlanManeuversResponse>();
+                auto req = pending_requests.find(plugin);
+                if (res && req != pending_requests.end())
+                {
+                    RecordedPlanManeuvers record;
+                    record.plugin = plugin;
+                    record.srv.request = req->second;
+                    record.srv.response = *res;
+                    record.cycle_start = cycle_started;
+                    if (cycle_started)
+                    {
+                        record.planning_start = planning_start;
+                    }
+                    cycle_started = false;
+                    records.push_back(record);
+                    pending_requests.erase(req);
+                }
+            }
+        }
+
+        return records;
+    }
+};
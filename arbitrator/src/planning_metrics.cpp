@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2019-2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include "planning_metrics.hpp"
+#include <algorithm>
+#include <numeric>
+
+namespace arbitrator
+{
+    namespace
+    {
+        void add_value(diagnostic_msgs::DiagnosticStatus& status, const std::string& key, const std::string& value)
+        {
+            diagnostic_msgs::KeyValue kv;
+            kv.key = key;
+            kv.value = value;
+            status.values.push_back(kv);
+        }
+    }
+
+    diagnostic_msgs::DiagnosticArray compose_planning_metrics(const PlanningStatistics& stats,
+        const std::map<std::string, PluginCallStatistics>& plugin_stats,
+        const ros::Time& stamp)
+    {
+        diagnostic_msgs::DiagnosticArray metrics;
+        metrics.header.stamp = stamp;
+
+        diagnostic_msgs::DiagnosticStatus search;
+        search.name = PLANNING_METRICS_SEARCH_STATUS;
+        search.level = stats.deadline_reached ? diagnostic_msgs::DiagnosticStatus::WARN : diagnostic_msgs::DiagnosticStatus::OK;
+        search.message = stats.deadline_reached ? "Search stopped at planning deadline" : "Search complete";
+
+        uint32_t max_open_list = 0;
+        double mean_open_list = 0.0;
+        if (!stats.open_list_sizes.empty())
+        {
+            max_open_list = *std::max_element(stats.open_list_sizes.begin(), stats.open_list_sizes.end());
+            mean_open_list = std::accumulate(stats.open_list_sizes.begin(), stats.open_list_sizes.end(), 0.0) / stats.open_list_sizes.size();
+        }
+
+        add_value(search, "nodes_expanded", std::to_string(stats.nodes_expanded));
+        add_value(search, "plans_evaluated", std::to_string(stats.plans_evaluated));
+        add_value(search, "search_depth", std::to_string(stats.search_depth));
+        add_value(search, "deadline_reached", stats.deadline_reached ? "true" : "false");
+        add_value(search, "planning_time_ms", std::to_string(stats.planning_time.toSec() * 1000.0));
+        add_value(search, "neighbor_generation_ms", std::to_string(stats.neighbor_generation_time.toSec() * 1000.0));
+        add_value(search, "cost_function_ms", std::to_string(stats.cost_function_time.toSec() * 1000.0));
+        add_value(search, "max_open_list_size", std::to_string(max_open_list));
+        add_value(search, "mean_open_list_size", std::to_string(mean_open_list));
+        add_value(search, "reused_maneuvers", std::to_string(stats.reused_maneuvers));
+        metrics.status.push_back(search);
+
+        for (auto it = plugin_stats.begin(); it != plugin_stats.end(); it++)
+        {
+            const PluginCallStatistics& plugin = it->second;
+            uint32_t responded = plugin.calls - plugin.timeouts;
+
+            diagnostic_msgs::DiagnosticStatus status;
+            status.name = it->first;
+            status.level = (plugin.failures > 0 || plugin.timeouts > 0 || plugin.skips > 0) ? diagnostic_msgs::DiagnosticStatus::WARN : diagnostic_msgs::DiagnosticStatus::OK;
+            add_value(status, "calls", std::to_string(plugin.calls));
+            add_value(status, "failures", std::to_string(plugin.failures));
+            add_value(status, "timeouts", std::to_string(plugin.timeouts));
+            add_value(status, "skips", std::to_string(plugin.skips));
+            add_value(status, "mean_latency_ms", std::to_string(responded > 0 ? plugin.total_latency_ms / responded : 0.0));
+            add_value(status, "max_latency_ms", std::to_string(plugin.max_latency_ms));
+            metrics.status.push_back(status);
+        }
+
+        return metrics;
+    }
+};
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2019-2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+#include <ros/ros.h>
+#include <cost_evaluator.hpp>
+#include "arbitrator_utils.hpp"
+#include "beam_search_strategy.hpp"
+#include "cost_function.hpp"
+#include "plan_maneuvers_bag.hpp"
+#include "replay_neighbor_generator.hpp"
+#include "tree_planner.hpp"
+
+/**
+ * Offline benchmark for the arbitrator search
+ * 
+ * Replays the strategic plugin responses recorded with the arbitrator's plugin_response_bag
+ * parameter through TreePlanner so search strategy changes can be compared without a vehicle.
+ * Cycles the arbitrator warm started are seeded with the same prior plan at the recorded planning
+ * start time, so prior_plan_reuse_duration should match the arbitrator's parameter.
+ * 
+ * Usage: replay_benchmark <bag_file> [beam_width=3] [target_plan_duration=15.0] [iterations=10] [prior_plan_reuse_duration=0.0]
+ */
+
+namespace
+{
+    /**
+     * \brief CostFunction which evaluates plans with the cost plugin system library at its default parameters
+     */
+    class ReplayCostFunction : public arbitrator::CostFunction
+    {
+        public:
+            double compute_total_cost(const cav_msgs::ManeuverPlan& plan)
+            {
+                return evaluator_.compute_cost(plan);
+            }
+
+            double compute_cost_per_unit_distance(const cav_msgs::ManeuverPlan& plan)
+            {
+                double plan_dist = arbitrator_utils::get_plan_end_distance(plan) - arbitrator_utils::get_plan_start_distance(plan);
+                return compute_total_cost(plan) / plan_dist;
+            }
+        private:
+            cost_plugin_system::CostEvaluator evaluator_;
+    };
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <bag_file> [beam_width=3] [target_plan_duration=15.0] [iterations=10] [prior_plan_reuse_duration=0.0]" << std::endl;
+        return 1;
+    }
+
+    std::string bag_file = argv[1];
+    int beam_width = argc > 2 ? std::atoi(argv[2]) : 3;
+    double target_plan_duration = argc > 3 ? std::atof(argv[3]) : 15.0;
+    int iterations = argc > 4 ? std::atoi(argv[4]) : 10;
+    double prior_plan_reuse_duration = argc > 5 ? std::atof(argv[5]) : 0.0;
+
+    // Warm started searches drop the maneuvers of their seed which expired by ros::Time::now(),
+    // so the clock is set to the recorded planning start time of each warm started cycle
+    ros::Time::init();
+
+    arbitrator::ReplayNeighborGenerator rng{arbitrator::read_plan_maneuvers_bag(bag_file)};
+    if (rng.get_cycle_count() == 0)
+    {
+        std::cerr << "No planning cycles found in " << bag_file << std::endl;
+        return 1;
+    }
+
+    ReplayCostFunction rcf;
+    arbitrator::BeamSearchStrategy bss{beam_width};
+    arbitrator::TreePlanner tp{rcf, rng, bss, ros::Duration(target_plan_duration), ros::Duration(prior_plan_reuse_duration)};
+
+    std::cout << "Replaying " << rng.get_cycle_count() << " planning cycles " << iterations << " times with beam width " 
+        << beam_width << " and target plan duration " << target_plan_duration << "s" << std::endl;
+    std::cout << "cycle,mean_planning_ms,max_planning_ms,neighbor_generation_ms,cost_function_ms,reused_maneuvers,nodes_expanded,plans_evaluated,search_depth,max_open_list_size,plan_duration_s" << std::endl;
+
+    double total_planning_ms = 0.0;
+    for (size_t cycle = 0; cycle < rng.get_cycle_count(); cycle++)
+    {
+        rng.set_cycle(cycle);
+        const cav_msgs::ManeuverPlan& root = rng.get_cycle_root();
+        if (!root.maneuvers.empty())
+        {
+            ros::Time::setNow(rng.get_cycle_planning_start());
+        }
+
+        double cycle_planning_ms = 0.0;
+        double max_planning_ms = 0.0;
+        double neighbor_generation_ms = 0.0;
+        double cost_function_ms = 0.0;
+        cav_msgs::ManeuverPlan plan;
+        arbitrator::PlanningStatistics stats;
+        for (int i = 0; i < iterations; i++)
+        {
+            // The seed is only used for one search
+            tp.set_prior_plan(root);
+            plan = tp.generate_plan();
+            stats = tp.get_last_planning_statistics();
+
+            double planning_ms = stats.planning_time.toSec() * 1000.0;
+            cycle_planning_ms += planning_ms;
+            max_planning_ms = std::max(max_planning_ms, planning_ms);
+            neighbor_generation_ms += stats.neighbor_generation_time.toSec() * 1000.0;
+            cost_function_ms += stats.cost_function_time.toSec() * 1000.0;
+        }
+        total_planning_ms += cycle_planning_ms;
+
+        uint32_t max_open_list = stats.open_list_sizes.empty() ? 0 : *std::max_element(stats.open_list_sizes.begin(), stats.open_list_sizes.end());
+        double plan_duration = plan.maneuvers.empty() ? 0.0 :
+            (arbitrator_utils::get_plan_end_time(plan) - arbitrator_utils::get_plan_start_time(plan)).toSec();
+
+        std::cout << cycle << ","
+            << cycle_planning_ms / iterations << ","
+            << max_planning_ms << ","
+            << neighbor_generation_ms / iterations << ","
+            << cost_function_ms / iterations << ","
+            << stats.reused_maneuvers << ","
+            << stats.nodes_expanded << ","
+            << stats.plans_evaluated << ","
+            << stats.search_depth << ","
+            << max_open_list << ","
+            << plan_duration << std::endl;
+    }
+
+    std::cout << "Mean planning time over all cycles: " << total_planning_ms / (iterations * rng.get_cycle_count()) << "ms" << std::endl;
+    return 0;
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2019-2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include "replay_neighbor_generator.hpp"
+#include "arbitrator_utils.hpp"
+#include <stdexcept>
+#include <algorithm>
+
+namespace arbitrator
+{
+    ReplayNeighborGenerator::ReplayNeighborGenerator(const std::vector<RecordedPlanManeuvers>& records)
+    {
+        bool has_cycle_markers = std::any_of(records.begin(), records.end(), 
+            [](const RecordedPlanManeuvers& record) { return record.cycle_start; });
+
+        bool cycle_has_expansions = false;
+        for (auto it = records.begin(); it != records.end(); it++)
+        {
+            const cav_msgs::ManeuverPlan& prior_plan = it->srv.request.prior_plan;
+            if (has_cycle_markers)
+            {
+                if (it->cycle_start)
+                {
+                    cycles_.emplace_back();
+                    cycles_.back().root = prior_plan;
+                    cycles_.back().planning_start = it->planning_start;
+                }
+                else if (cycles_.empty())
+                {
+                    // Recording began partway through a cycle, nothing can be replayed until the next marker
+                    continue;
+                }
+            }
+            else if (prior_plan.maneuvers.empty())
+            {
+                if (cycles_.empty() || cycle_has_expansions)
+                {
+                    cycles_.emplace_back();
+                    cycle_has_expansions = false;
+                }
+            }
+            else if (cycles_.empty())
+            {
+                // Recording began partway through a cycle, nothing can be replayed until the next root
+                continue;
+            }
+            else
+            {
+                cycle_has_expansions = true;
+            }
+
+            cycles_.back().responses[arbitrator_utils::get_maneuver_sequence_key(prior_plan)].push_back(it->srv.response.new_plan);
+        }
+    }
+
+    size_t ReplayNeighborGenerator::get_cycle_count() const
+    {
+        return cycles_.size();
+    }
+
+    void ReplayNeighborGenerator::set_cycle(size_t cycle)
+    {
+        if (cycle >= cycles_.size())
+        {
+            throw std::out_of_range("ReplayNeighborGenerator::set_cycle called with a cycle which was not recorded");
+        }
+        current_cycle_ = cycle;
+    }
+
+    const cav_msgs::ManeuverPlan& ReplayNeighborGenerator::get_cycle_root() const
+    {
+        static const cav_msgs::ManeuverPlan empty_root;
+        return cycles_.empty() ? empty_root : cycles_[current_cycle_].root;
+    }
+
+    ros::Time ReplayNeighborGenerator::get_cycle_planning_start() const
+    {
+        return cycles_.empty() ? ros::Time() : cycles_[current_cycle_].planning_start;
+    }
+
+    std::vector<cav_msgs::ManeuverPlan> ReplayNeighborGenerator::generate_neighbors(cav_msgs::ManeuverPlan plan) const
+    {
+        if (cycles_.empty())
+        {
+            return std::vector<cav_msgs::ManeuverPlan>();
+        }
+
+        const ResponseTable& responses = cycles_[current_cycle_].responses;
+        auto it = responses.find(arbitrator_utils::get_maneuver_sequence_key(plan));
+        if (it == responses.end())
+        {
+            return std::vector<cav_msgs::ManeuverPlan>();
+        }
+        return it->second;
+    }
+};
@@ -18,34 +18,93 @@
 #include "arbitrator_utils.hpp"
 #include <vector>
 #include <map>
+#include <algorithm>
+#include <unordered_map>
 #include <limits>
+#include <utility>
 
 namespace arbitrator
 {
+    std::string TreePlanner::maneuver_sequence_key(const cav_msgs::ManeuverPlan& plan) const
+    {
+        return arbitrator_utils::get_maneuver_sequence_key(plan);
+    }
+
     cav_msgs::ManeuverPlan TreePlanner::generate_plan() 
     {
+        ros::WallTime start_time = ros::WallTime::now();
+        cav_msgs::ManeuverPlan plan = search(boost::none);
+        last_statistics_.planning_time = ros::WallTime::now() - start_time;
+        return plan;
+    }
+
+    cav_msgs::ManeuverPlan TreePlanner::generate_plan(const ros::WallTime& deadline) 
+    {
+        ros::WallTime start_time = ros::WallTime::now();
+        cav_msgs::ManeuverPlan plan = search(deadline);
+        last_statistics_.planning_time = ros::WallTime::now() - start_time;
+        return plan;
+    }
+
+    void TreePlanner::set_prior_plan(const cav_msgs::ManeuverPlan& plan)
+    {
+        prior_plan_ = plan;
+    }
+
+    PlanningStatistics TreePlanner::get_last_planning_statistics() const
+    {
+        return last_statistics_;
+    }
+
+    cav_msgs::ManeuverPlan TreePlanner::search(const boost::optional<ros::WallTime>& deadline) 
+    {
+        last_statistics_ = PlanningStatistics();
+
+        // Seed the search with the unexpired maneuvers of the prior plan if one was provided
         cav_msgs::ManeuverPlan root;
+        ros::Time search_start;
+        if (!prior_plan_.maneuvers.empty())
+        {
+            search_start = ros::Time::now();
+            root = arbitrator_utils::get_unexpired_plan(prior_plan_, search_start);
+            prior_plan_ = cav_msgs::ManeuverPlan();
+        }
+        const bool warm_start = !root.maneuvers.empty();
+        last_statistics_.reused_maneuvers = root.maneuvers.size();
+
         std::vector<std::pair<cav_msgs::ManeuverPlan, double>> open_list;
         const double INF = std::numeric_limits<double>::infinity();
-        open_list.push_back(std::make_pair(root, INF));
+        open_list.emplace_back(std::move(root), INF);
 
-        cav_msgs::ManeuverPlan longest_plan = root; // Track longest plan in case target length is never reached
+        cav_msgs::ManeuverPlan longest_plan; // Track longest plan in case target length is never reached
         ros::Duration longest_plan_duration = ros::Duration(0);
 
+        // Transposition tables for this planning cycle so plans with identical maneuver sequences 
+        // reached through different branches are only expanded and costed once
+        std::unordered_map<std::string, std::vector<cav_msgs::ManeuverPlan>> expanded_children;
+        std::unordered_map<std::string, double> computed_costs;
+
         while (!open_list.empty())
         {
+            last_statistics_.search_depth++;
             std::vector<std::pair<cav_msgs::ManeuverPlan, double>> new_open_list;
             for (auto it = open_list.begin(); it != open_list.end(); it++)
             {
                 // Pop the first element off the open list
-                cav_msgs::ManeuverPlan cur_plan = it->first;
+                const cav_msgs::ManeuverPlan& cur_plan = it->first;
                 ros::Duration plan_duration; // zero duration
 
                 // If we're not at the root, plan_duration is nonzero (our plan should have maneuvers)
                 if (!cur_plan.maneuvers.empty()) 
                 {
-                    // get plan duration
-                    plan_duration = arbitrator_utils::get_plan_end_time(cur_plan) - arbitrator_utils::get_plan_start_time(cur_plan); 
+                    // get plan duration. Reused maneuvers began in the past, so a warm started 
+                    // search only counts the part of the plan after the search started
+                    ros::Time plan_start = arbitrator_utils::get_plan_start_time(cur_plan);
+                    if (warm_start && plan_start < search_start)
+                    {
+                        plan_start = search_start;
+                    }
+                    plan_duration = arbitrator_utils::get_plan_end_time(cur_plan) - plan_start; 
                 }
                 // Evaluate terminal condition
                 if (plan_duration >= target_plan_duration_) 
@@ -56,20 +115,76 @@ namespace arbitrator
                     longest_plan = cur_plan;
                 }
 
+                // Keep following the seeded plan without expanding it while it still covers enough
+                if (warm_start && last_statistics_.search_depth == 1 && 
+                    prior_plan_reuse_duration_ > ros::Duration(0) && plan_duration >= prior_plan_reuse_duration_)
+                {
+                    return cur_plan;
+                }
+
+                // Stop with the best plan found so far once out of time
+                if (deadline && ros::WallTime::now() >= *deadline)
+                {
+                    last_statistics_.deadline_reached = true;
+                    return longest_plan;
+                }
+
                 // Expand it, and reprioritize
-                std::vector<cav_msgs::ManeuverPlan> children = neighbor_generator_.generate_neighbors(cur_plan);
+                std::string cur_key = maneuver_sequence_key(cur_plan);
+                auto expansion = expanded_children.find(cur_key);
+                if (expansion == expanded_children.end())
+                {
+                    ros::WallTime expansion_start = ros::WallTime::now();
+                    expansion = expanded_children.emplace(cur_key, neighbor_generator_.generate_neighbors(cur_plan)).first;
+                    last_statistics_.neighbor_generation_time += ros::WallTime::now() - expansion_start;
+                    last_statistics_.nodes_expanded++;
+                }
+                const std::vector<cav_msgs::ManeuverPlan>& children = expansion->second;
                 
-                // Compute cost for each child and store in open list
-                for (auto child = children.begin(); child != children.end(); child++)
+                // Cost all children not yet seen this cycle in a single batch
+                std::vector<std::string> child_keys(children.size());
+                std::vector<const cav_msgs::ManeuverPlan*> uncosted_children;
+                std::vector<std::string> uncosted_keys;
+                for (size_t i = 0; i < children.size(); i++)
+                {
+                    if (children[i].maneuvers.empty())
+                        continue;
+                    std::string child_key = maneuver_sequence_key(children[i]);
+                    // A child identical to its parent, such as a seeded plan returned unextended, adds nothing
+                    if (child_key == cur_key)
+                        continue;
+                    child_keys[i] = std::move(child_key);
+                    if (computed_costs.find(child_keys[i]) == computed_costs.end() &&
+                        std::find(uncosted_keys.begin(), uncosted_keys.end(), child_keys[i]) == uncosted_keys.end())
+                    {
+                        uncosted_children.push_back(&children[i]);
+                        uncosted_keys.push_back(child_keys[i]);
+                    }
+                }
+
+                if (!uncosted_children.empty())
+                {
+                    ros::WallTime cost_start = ros::WallTime::now();
+                    std::vector<double> costs = cost_function_.compute_costs_per_unit_distance(uncosted_children);
+                    last_statistics_.cost_function_time += ros::WallTime::now() - cost_start;
+                    for (size_t i = 0; i < uncosted_keys.size(); i++)
+                    {
+                        computed_costs.emplace(std::move(uncosted_keys[i]), costs[i]);
+                    }
+                    last_statistics_.plans_evaluated += uncosted_children.size();
+                }
+
+                // Store each child with its cost in the open list
+                for (size_t i = 0; i < children.size(); i++)
                 {
-                    if (child->maneuvers.empty())
-                        continue;   
-                    new_open_list.push_back(std::make_pair(*child, cost_function_.compute_cost_per_unit_distance(*child)));
+                    if (child_keys[i].empty())
+                        continue;
+                    new_open_list.emplace_back(children[i], computed_costs.at(child_keys[i]));
                 }
             }
             
-            new_open_list = search_strategy_.prioritize_plans(new_open_list);
-            open_list = new_open_list;
+            open_list = search_strategy_.prioritize_plans(std::move(new_open_list));
+            last_statistics_.open_list_sizes.push_back(open_list.size());
         }
 
 
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2019-2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include "capabilities_interface.hpp"
+#include <cav_srvs/PlanManeuvers.h>
+#include <gtest/gtest.h>
+#include <atomic>
+
+namespace arbitrator
+{
+    const std::string FAST_PLUGIN = "/test_plugins/fast/plan_maneuvers";
+    const std::string SLOW_PLUGIN = "/test_plugins/slow/plan_maneuvers";
+
+    TEST(CapabilitiesInterfaceTest, testTimeoutAndSkip)
+    {
+        ros::NodeHandle nh;
+        std::atomic<bool> release_slow(false);
+
+        ros::ServiceServer discovery = nh.advertiseService<cav_srvs::GetPluginApiRequest, cav_srvs::GetPluginApiResponse>(
+            "plugins/get_strategic_plugin_by_capability", 
+            [](cav_srvs::GetPluginApiRequest&, cav_srvs::GetPluginApiResponse& res) 
+            {
+                res.plan_service = {FAST_PLUGIN, SLOW_PLUGIN};
+                return true;
+            });
+        ros::ServiceServer fast = nh.advertiseService<cav_srvs::PlanManeuversRequest, cav_srvs::PlanManeuversResponse>(
+            FAST_PLUGIN, 
+            [](cav_srvs::PlanManeuversRequest&, cav_srvs::PlanManeuversResponse&) { return true; });
+        ros::ServiceServer slow = nh.advertiseService<cav_srvs::PlanManeuversRequest, cav_srvs::PlanManeuversResponse>(
+            SLOW_PLUGIN, 
+            [&release_slow](cav_srvs::PlanManeuversRequest&, cav_srvs::PlanManeuversResponse&) 
+            {
+                while (!release_slow && ros::ok())
+                {
+                    ros::WallDuration(0.01).sleep();
+                }
+                return true;
+            });
+
+        ros::AsyncSpinner spinner(4);
+        spinner.start();
+        ASSERT_TRUE(ros::service::waitForService(SLOW_PLUGIN, ros::Duration(5.0)));
+
+        {
+            CapabilitiesInterface ci{&nh, ros::WallDuration(0.2)};
+            cav_srvs::PlanManeuvers msg;
+
+            // The slow plugin misses the timeout and is left out of the responses
+            auto responses = ci.multiplex_service_call_for_capability(CapabilitiesInterface::STRATEGIC_PLAN_CAPABILITY, msg);
+            ASSERT_EQ(1, responses.size());
+            ASSERT_EQ(1, responses.count(FAST_PLUGIN));
+            auto stats = ci.get_plugin_call_statistics();
+            ASSERT_EQ(1, stats[SLOW_PLUGIN].calls);
+            ASSERT_EQ(1, stats[SLOW_PLUGIN].timeouts);
+            ASSERT_EQ(0, stats[SLOW_PLUGIN].skips);
+
+            // While its call is outstanding the slow plugin is skipped and the skip is reported
+            responses = ci.multiplex_service_call_for_capability(CapabilitiesInterface::STRATEGIC_PLAN_CAPABILITY, msg);
+            ASSERT_EQ(1, responses.size());
+            stats = ci.get_plugin_call_statistics();
+            ASSERT_EQ(1, stats[SLOW_PLUGIN].calls);
+            ASSERT_EQ(1, stats[SLOW_PLUGIN].skips);
+            ASSERT_EQ(2, stats[FAST_PLUGIN].calls);
+
+            // Once the outstanding call completes the plugin is called again
+            release_slow = true;
+            ros::WallDuration(0.5).sleep();
+            responses = ci.multiplex_service_call_for_capability(CapabilitiesInterface::STRATEGIC_PLAN_CAPABILITY, msg);
+            ASSERT_EQ(2, responses.size());
+            stats = ci.get_plugin_call_statistics();
+            ASSERT_EQ(2, stats[SLOW_PLUGIN].calls);
+            ASSERT_EQ(1, stats[SLOW_PLUGIN].skips);
+        }
+
+        // Destroying the interface cancels an outstanding call instead of waiting for the plugin
+        release_slow = false;
+        ros::WallTime destroy_start;
+        {
+            CapabilitiesInterface ci{&nh, ros::WallDuration(0.2)};
+            cav_srvs::PlanManeuvers msg;
+            auto responses = ci.multiplex_service_call_for_capability(CapabilitiesInterface::STRATEGIC_PLAN_CAPABILITY, msg);
+            ASSERT_EQ(1, responses.size());
+            destroy_start = ros::WallTime::now();
+        }
+        ASSERT_LT((ros::WallTime::now() - destroy_start).toSec(), 2.0);
+
+        release_slow = true;
+        spinner.stop();
+    }
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    ros::init(argc, argv, "test_capabilities_interface");
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2019-2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include "planning_metrics.hpp"
+#include <gtest/gtest.h>
+#include <unordered_map>
+
+namespace arbitrator
+{
+    std::unordered_map<std::string, std::string> status_values(const diagnostic_msgs::DiagnosticStatus& status)
+    {
+        std::unordered_map<std::string, std::string> values;
+        for (const auto& kv : status.values)
+        {
+            values[kv.key] = kv.value;
+        }
+        return values;
+    }
+
+    TEST(PlanningMetricsTest, testComposePlanningMetrics)
+    {
+        PlanningStatistics stats;
+        stats.nodes_expanded = 4;
+        stats.plans_evaluated = 9;
+        stats.search_depth = 3;
+        stats.open_list_sizes = {3, 3, 0};
+
+        std::map<std::string, PluginCallStatistics> plugin_stats;
+        PluginCallStatistics plugin_a;
+        plugin_a.calls = 4;
+        plugin_a.total_latency_ms = 12.0;
+        plugin_a.max_latency_ms = 6.0;
+        plugin_stats["plugin_a"] = plugin_a;
+        PluginCallStatistics plugin_b;
+        plugin_b.calls = 4;
+        plugin_b.timeouts = 2;
+        plugin_b.skips = 1;
+        plugin_b.total_latency_ms = 4.0;
+        plugin_b.max_latency_ms = 3.0;
+        plugin_stats["plugin_b"] = plugin_b;
+
+        diagnostic_msgs::DiagnosticArray metrics = compose_planning_metrics(stats, plugin_stats, ros::Time(1.0));
+
+        ASSERT_EQ(3, metrics.status.size());
+        ASSERT_EQ(PLANNING_METRICS_SEARCH_STATUS, metrics.status[0].name);
+        ASSERT_EQ(diagnostic_msgs::DiagnosticStatus::OK, metrics.status[0].level);
+        auto search = status_values(metrics.status[0]);
+        ASSERT_EQ("4", search["nodes_expanded"]);
+        ASSERT_EQ("9", search["plans_evaluated"]);
+        ASSERT_EQ("3", search["search_depth"]);
+        ASSERT_EQ("3", search["max_open_list_size"]);
+        ASSERT_NEAR(2.0, std::stod(search["mean_open_list_size"]), 0.001);
+
+        ASSERT_EQ("plugin_a", metrics.status[1].name);
+        ASSERT_EQ(diagnostic_msgs::DiagnosticStatus::OK, metrics.status[1].level);
+        ASSERT_NEAR(3.0, std::stod(status_values(metrics.status[1])["mean_latency_ms"]), 0.001);
+
+        ASSERT_EQ("plugin_b", metrics.status[2].name);
+        ASSERT_EQ(diagnostic_msgs::DiagnosticStatus::WARN, metrics.status[2].level);
+        ASSERT_EQ("2", status_values(metrics.status[2])["timeouts"]);
+        ASSERT_EQ("1", status_values(metrics.status[2])["skips"]);
+        ASSERT_NEAR(2.0, std::stod(status_values(metrics.status[2])["mean_latency_ms"]), 0.001);
+    }
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2019-2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include "replay_neighbor_generator.hpp"
+#include <gtest/gtest.h>
+
+namespace arbitrator
+{
+    cav_msgs::Maneuver lane_following(double start_time, double end_time)
+    {
+        cav_msgs::Maneuver mvr;
+        mvr.type = cav_msgs::Maneuver::LANE_FOLLOWING;
+        mvr.lane_following_maneuver.start_time = ros::Time(start_time);
+        mvr.lane_following_maneuver.end_time = ros::Time(end_time);
+        return mvr;
+    }
+
+    RecordedPlanManeuvers record(const std::string& plugin, const cav_msgs::ManeuverPlan& prior, const cav_msgs::ManeuverPlan& next)
+    {
+        RecordedPlanManeuvers r;
+        r.plugin = plugin;
+        r.srv.request.prior_plan = prior;
+        r.srv.response.new_plan = next;
+        return r;
+    }
+
+    TEST(ReplayNeighborGeneratorTest, testReplayCycles)
+    {
+        cav_msgs::ManeuverPlan root, a, ab, b;
+        a.maneuvers.push_back(lane_following(0, 1));
+        ab = a;
+        ab.maneuvers.push_back(lane_following(1, 2));
+        b.maneuvers.push_back(lane_following(0, 3));
+
+        std::vector<RecordedPlanManeuvers> records;
+        // Partial cycle before the first root request is ignored
+        records.push_back(record("plugin_a", a, ab));
+        // Cycle 0
+        records.push_back(record("plugin_a", root, a));
+        records.push_back(record("plugin_b", root, b));
+        records.push_back(record("plugin_a", a, ab));
+        // Cycle 1
+        records.push_back(record("plugin_b", root, b));
+
+        ReplayNeighborGenerator rng{records};
+        ASSERT_EQ(2, rng.get_cycle_count());
+        // Cycles without markers always start from the empty root
+        ASSERT_TRUE(rng.get_cycle_root().maneuvers.empty());
+        ASSERT_EQ(ros::Time(), rng.get_cycle_planning_start());
+
+        std::vector<cav_msgs::ManeuverPlan> children = rng.generate_neighbors(root);
+        ASSERT_EQ(2, children.size());
+        ASSERT_EQ(ros::Time(1), children[0].maneuvers.back().lane_following_maneuver.end_time);
+        ASSERT_EQ(ros::Time(3), children[1].maneuvers.back().lane_following_maneuver.end_time);
+
+        // Plan IDs are ignored when matching the prior plan
+        cav_msgs::ManeuverPlan a_with_id = a;
+        a_with_id.maneuver_plan_id = "id";
+        children = rng.generate_neighbors(a_with_id);
+        ASSERT_EQ(1, children.size());
+        ASSERT_EQ(2, children[0].maneuvers.size());
+        ASSERT_TRUE(rng.generate_neighbors(ab).empty());
+
+        rng.set_cycle(1);
+        children = rng.generate_neighbors(root);
+        ASSERT_EQ(1, children.size());
+        ASSERT_EQ(ros::Time(3), children[0].maneuvers.back().lane_following_maneuver.end_time);
+        ASSERT_TRUE(rng.generate_neighbors(a).empty());
+
+        ASSERT_THROW(rng.set_cycle(2), std::out_of_range);
+    }
+
+    TEST(ReplayNeighborGeneratorTest, testReplayCycleMarkers)
+    {
+        cav_msgs::ManeuverPlan a, ab, abc;
+        a.maneuvers.push_back(lane_following(0, 1));
+        ab = a;
+        ab.maneuvers.push_back(lane_following(1, 2));
+        abc = ab;
+        abc.maneuvers.push_back(lane_following(2, 3));
+
+        // Warm started cycles never request the empty root plan
+        std::vector<RecordedPlanManeuvers> records;
+        // Partial cycle before the first marker is ignored
+        records.push_back(record("plugin_a", ab, abc));
+        // Cycle 0
+        records.push_back(record("plugin_a", a, ab));
+        records.back().cycle_start = true;
+        records.back().planning_start = ros::Time(0.5);
+        records.push_back(record("plugin_a", ab, abc));
+        // Cycle 1, seeded with ab
+        records.push_back(record("plugin_b", ab, abc));
+        records.back().cycle_start = true;
+        records.back().planning_start = ros::Time(1.5);
+
+        ReplayNeighborGenerator rng{records};
+        ASSERT_EQ(2, rng.get_cycle_count());
+        // The first plan expanded in a cycle is the seed of the warm started search
+        ASSERT_EQ(1, rng.get_cycle_root().maneuvers.size());
+        ASSERT_EQ(ros::Time(0.5), rng.get_cycle_planning_start());
+
+        std::vector<cav_msgs::ManeuverPlan> children = rng.generate_neighbors(a);
+        ASSERT_EQ(1, children.size());
+        ASSERT_EQ(2, children[0].maneuvers.size());
+        ASSERT_EQ(1, rng.generate_neighbors(ab).size());
+
+        rng.set_cycle(1);
+        ASSERT_EQ(2, rng.get_cycle_root().maneuvers.size());
+        ASSERT_EQ(ros::Time(1.5), rng.get_cycle_planning_start());
+        children = rng.generate_neighbors(ab);
+        ASSERT_EQ(1, children.size());
+        ASSERT_EQ(3, children[0].maneuvers.size());
+        ASSERT_TRUE(rng.generate_neighbors(a).empty());
+    }
+}
@@ -225,4 +225,126 @@ namespace arbitrator
         ASSERT_EQ(ros::Time(4), plan.maneuvers[2].lane_following_maneuver.start_time);
         ASSERT_EQ(ros::Time(5), plan.maneuvers[2].lane_following_maneuver.end_time);
     }
-}
\ No newline at end of file
+
+    TEST_F(TreePlannerTest, testGeneratePlanTransposition)
+    {
+        cav_msgs::ManeuverPlan plan1, plan2;
+        cav_msgs::Maneuver mvr1;
+
+        mvr1.type = cav_msgs::Maneuver::LANE_FOLLOWING;
+        mvr1.lane_following_maneuver.start_time = ros::Time(0);
+        mvr1.lane_following_maneuver.end_time = ros::Time(2);
+
+        // Identical maneuver sequences from different plugins
+        plan1.maneuvers.push_back(mvr1);
+        plan1.maneuver_plan_id = "plan_a";
+        plan2.maneuvers.push_back(mvr1);
+        plan2.maneuver_plan_id = "plan_b";
+
+        std::vector<cav_msgs::ManeuverPlan> plans{plan1, plan2};
+
+        {
+            InSequence seq;
+            EXPECT_CALL(mng, generate_neighbors(_))
+                .WillOnce(
+                    Return(plans)
+                );
+            EXPECT_CALL(mng, generate_neighbors(_))
+                .WillOnce(
+                    Return(std::vector<cav_msgs::ManeuverPlan>())
+                );
+        }
+
+        EXPECT_CALL(mcf, compute_cost_per_unit_distance(_))
+            .Times(1)
+            .WillRepeatedly(
+                Return(5.0)
+            );
+
+        EXPECT_CALL(mss, prioritize_plans(_))
+            .WillRepeatedly(
+                ReturnArg<0>()
+            );
+
+        cav_msgs::ManeuverPlan plan = tp.generate_plan();
+        ASSERT_EQ(1, plan.maneuvers.size());
+        ASSERT_EQ(ros::Time(2), plan.maneuvers[0].lane_following_maneuver.end_time);
+    }
+
+    TEST_F(TreePlannerTest, testGeneratePlanDeadline)
+    {
+        EXPECT_CALL(mng, generate_neighbors(_))
+            .Times(0);
+
+        EXPECT_CALL(mcf, compute_cost_per_unit_distance(_))
+            .Times(0);
+
+        // A deadline which has already passed returns the best plan so far without expanding the root
+        cav_msgs::ManeuverPlan plan = tp.generate_plan(ros::WallTime::now() - ros::WallDuration(1.0));
+        ASSERT_TRUE(plan.maneuvers.empty());
+
+        PlanningStatistics stats = tp.get_last_planning_statistics();
+        ASSERT_TRUE(stats.deadline_reached);
+        ASSERT_EQ(0, stats.nodes_expanded);
+        ASSERT_EQ(1, stats.search_depth);
+    }
+
+    TEST_F(TreePlannerTest, testGeneratePlanWarmStart)
+    {
+        ros::Time::init();
+        ros::Time now = ros::Time::now();
+        cav_msgs::ManeuverPlan prior_plan, child;
+        cav_msgs::Maneuver expired, active, upcoming, extension;
+
+        expired.type = cav_msgs::Maneuver::LANE_FOLLOWING;
+        expired.lane_following_maneuver.start_time = now - ros::Duration(4.0);
+        expired.lane_following_maneuver.end_time = now - ros::Duration(1.0);
+
+        active.type = cav_msgs::Maneuver::LANE_FOLLOWING;
+        active.lane_following_maneuver.start_time = now - ros::Duration(1.0);
+        active.lane_following_maneuver.end_time = now + ros::Duration(60.0);
+
+        upcoming.type = cav_msgs::Maneuver::LANE_FOLLOWING;
+        upcoming.lane_following_maneuver.start_time = now + ros::Duration(60.0);
+        upcoming.lane_following_maneuver.end_time = now + ros::Duration(62.0);
+
+        extension.type = cav_msgs::Maneuver::LANE_FOLLOWING;
+        extension.lane_following_maneuver.start_time = now + ros::Duration(62.0);
+        extension.lane_following_maneuver.end_time = now + ros::Duration(70.0);
+
+        prior_plan.maneuver_plan_id = "prior";
+        prior_plan.maneuvers = {expired, active, upcoming};
+        child.maneuvers = {active, upcoming, extension};
+
+        // Only the unexpired maneuvers are offered to the plugins for extension, without the prior plan ID
+        EXPECT_CALL(mng, generate_neighbors(::testing::Truly([](const cav_msgs::ManeuverPlan& plan) 
+            { return plan.maneuvers.size() == 2 && plan.maneuver_plan_id.empty(); })))
+            .WillOnce(
+                Return(std::vector<cav_msgs::ManeuverPlan>{child})
+            );
+
+        EXPECT_CALL(mcf, compute_cost_per_unit_distance(_))
+            .WillRepeatedly(
+                Return(5.0)
+            );
+
+        EXPECT_CALL(mss, prioritize_plans(_))
+            .WillRepeatedly(
+                ReturnArg<0>()
+            );
+
+        TreePlanner planner{mcf, mng, mss, ros::Duration(65)};
+        planner.set_prior_plan(prior_plan);
+        cav_msgs::ManeuverPlan plan = planner.generate_plan();
+        ASSERT_EQ(3, plan.maneuvers.size());
+        ASSERT_EQ(now + ros::Duration(70.0), plan.maneuvers[2].lane_following_maneuver.end_time);
+        ASSERT_EQ(2, planner.get_last_planning_statistics().reused_maneuvers);
+
+        // Reusing the prior plan without expansion when it still covers the reuse duration
+        TreePlanner reuse_planner{mcf, mng, mss, ros::Duration(65), ros::Duration(30)};
+        reuse_planner.set_prior_plan(prior_plan);
+        plan = reuse_planner.generate_plan();
+        ASSERT_EQ(2, plan.maneuvers.size());
+        ASSERT_EQ(0, reuse_planner.get_last_planning_statistics().nodes_expanded);
+    }
+}
@@ -20,6 +20,7 @@
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_io.hpp>
 #include <boost/uuid/uuid_generators.hpp>
+#include <boost/serialization/version.hpp>
 #include <lanelet2_core/LaneletMap.h>
 #include <autoware_lanelet2_msgs/MapBin.h>
 #include <lanelet2_io/io_handlers/Serialize.h>
@@ -46,6 +47,9 @@ public:
                  id_(id), update_list_(update_list), remove_list_(remove_list){}  
 
   boost::uuids::uuid id_;  // Unique id of this geofence
+  // Number of updates published by the broadcaster since its base map up to and including this one.
+  // 0 if the update is not versioned. A compacted snapshot carries the version of the last update it contains
+  size_t map_version_ = 0;
   // elements needed for broadcasting to the rest of map users
   std::vector<std::pair<lanelet::Id, lanelet::RegulatoryElementPtr>> update_list_;
   std::vector<std::pair<lanelet::Id, lanelet::RegulatoryElementPtr>> remove_list_;
@@ -94,11 +98,13 @@ inline void save(Archive& ar, const carma_wm::TrafficControl& gf, unsigned int /
   size_t update_list_size = gf.update_list_.size();
   ar << update_list_size;
   for (auto pair : gf.update_list_) ar << pair;
+
+  ar << gf.map_version_;
 }
 
 template <class Archive>
 // NOLINTNEXTLINE
-inline void load(Archive& ar, carma_wm::TrafficControl& gf, unsigned int /*version*/) 
+inline void load(Archive& ar, carma_wm::TrafficControl& gf, unsigned int version) 
 {
   boost::uuids::string_generator gen;
   std::string id;
@@ -123,6 +129,10 @@ inline void load(Archive& ar, carma_wm::TrafficControl& gf, unsigned int /*versi
     ar >> update_item;
     gf.update_list_.push_back(update_item);
   }
+
+  // updates serialized before versioning was added are not versioned
+  if (version >= 1)
+    ar >> gf.map_version_;
 }
 
 template <typename Archive>
@@ -135,4 +145,5 @@ void serialize(Archive& ar, std::pair<lanelet::Id, lanelet::RegulatoryElementPtr
 } // namespace serialization
 } // namespace boost
 
-BOOST_SERIALIZATION_SPLIT_FREE(carma_wm::TrafficControl);
\ No newline at end of file
+BOOST_SERIALIZATION_SPLIT_FREE(carma_wm::TrafficControl);
+BOOST_CLASS_VERSION(carma_wm::TrafficControl, 1);
\ No newline at end of file
@@ -108,14 +108,23 @@ public:
 private:
   // Callback function that uses lock to edit the map
   void mapUpdateCallback(const autoware_lanelet2_msgs::MapBinConstPtr& geofence_msg);
+  // Callback function that uses lock to bring the map up to date when this listener starts after map updates were published
+  void mapUpdateSnapshotCallback(const autoware_lanelet2_msgs::MapBinConstPtr& snapshot_msg);
+  // Timer callback that uses lock to repeat a request for map updates which has not been answered
+  void mapUpdateRequestTimerCallback(const ros::TimerEvent& event);
+  // Period in seconds at which an unanswered request for map updates is repeated
+  static constexpr double MAP_UPDATE_REQUEST_RETRY_PERIOD = 1.0;
   ros::Subscriber roadway_objects_sub_;
   ros::Subscriber map_update_sub_;
+  ros::Subscriber map_update_snapshot_sub_;
+  ros::Publisher map_update_request_pub_;
   std::unique_ptr<WMListenerWorker> worker_;
   ros::CARMANodeHandle nh_;
   ros::CallbackQueue async_queue_;
   std::unique_ptr<ros::AsyncSpinner> wm_spinner_;
   ros::Subscriber map_sub_;
   ros::Subscriber route_sub_;
+  ros::Timer map_update_request_timer_;
   const bool multi_threaded_;
   std::mutex mw_mutex_;
  
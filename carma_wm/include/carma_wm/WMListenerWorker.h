@@ -43,6 +43,9 @@ public:
   /*!
    * \brief Callback for new map messages. Updates the underlying map
    *
+   * The map carries no map updates so the snapshot of every update since the base map is requested through the map
+   * update request callback
+   *
    * \param map_msg The new map messages to generate the map from
    */
   void mapCallback(const autoware_lanelet2_msgs::MapBinConstPtr& map_msg);
@@ -50,9 +53,47 @@ public:
   /*!
    * \brief Callback for new map update messages (geofence). Updates the underlying map
    *
+   * Versioned updates which were already applied are ignored. If updates were missed the update is dropped
+   * and the missed updates are requested through the map update request callback instead
+   *
    * \param geofence_msg The new map update messages to generate the map edits from
    */
-  void mapUpdateCallback(const autoware_lanelet2_msgs::MapBinConstPtr& geofence_msg) const;
+  void mapUpdateCallback(const autoware_lanelet2_msgs::MapBinConstPtr& geofence_msg);
+
+  /*!
+   * \brief Callback for compacted map update snapshots. Brings a map which has no updates applied up to the snapshot version
+   *
+   * Snapshots are ignored before the map arrives and once versioned updates have been applied. The snapshot is requested
+   * again after each new map
+   *
+   * \param snapshot_msg The snapshot holding the net changes of every map update since the base map
+   */
+  void mapUpdateSnapshotCallback(const autoware_lanelet2_msgs::MapBinConstPtr& snapshot_msg);
+
+  /*!
+   * \brief Allows user to set a callback to be triggered when missed map updates need to be requested
+   *
+   * \param callback A callback function which requests every map update after the provided version
+   */
+  void setMapUpdateRequestCallback(std::function<void(size_t)> callback);
+
+  /*!
+   * \brief Returns the version of the last versioned map update applied to the map. 0 if there is none
+   */
+  size_t getMapUpdateVersion() const;
+
+  /*!
+   * \brief Repeats the last request for map updates if it has not been answered yet
+   *
+   * The request and its reply are plain messages which are lost if either side is not connected yet, so this should be
+   * called periodically. A request is answered by any snapshot or by the first requested update which is applied
+   */
+  void resendMapUpdateRequest();
+
+  /*!
+   * \brief Returns true if map updates were requested and the reply has not been received yet
+   */
+  bool isMapUpdateRequestPending() const;
 
   /*!
    * \brief Callback for route message. It is a TODO: To update function when route message spec is defined
@@ -97,7 +138,13 @@ private:
   std::shared_ptr<CARMAWorldModel> world_model_;
   std::function<void()> map_callback_;
   std::function<void()> route_callback_;
+  std::function<void(size_t)> map_update_request_callback_;
+  void applyMapUpdate(const carma_wm::TrafficControl& gf) const;
   void newRegemUpdateHelper(lanelet::Lanelet parent_llt, lanelet::RegulatoryElement* regem) const;
+  void requestMapUpdates(size_t since_version);
+  size_t map_update_version_ = 0;
+  bool map_update_request_pending_ = false;
+  size_t map_update_request_version_ = 0;
   double config_speed_limit_;
 
 };
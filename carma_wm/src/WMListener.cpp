@@ -15,8 +15,9 @@
  */
 
 #include <new>
+#include <std_msgs/UInt64.h>
 #include <carma_wm/WMListener.h>
-#include "WMListenerWorker.h"
+#include <carma_wm/WMListenerWorker.h>
 
 namespace carma_wm
 {
@@ -31,7 +32,17 @@ WMListener::WMListener(bool multi_thread) : worker_(std::unique_ptr<WMListenerWo
     ROS_DEBUG_STREAM("WMListener: Using multi-threaded subscription");
     nh_.setCallbackQueue(&async_queue_);
   }
-  map_update_sub_= nh_.subscribe("map_update", 1, &WMListener::mapUpdateCallback, this);
+  // missed updates are republished as a burst so the queue must hold more than one
+  map_update_sub_= nh_.subscribe("map_update", 100, &WMListener::mapUpdateCallback, this);
+  map_update_snapshot_sub_ = nh_.subscribe("map_update_snapshot", 1, &WMListener::mapUpdateSnapshotCallback, this);
+  map_update_request_pub_ = nh_.advertise<std_msgs::UInt64>("map_update_request", 1);
+  worker_->setMapUpdateRequestCallback([this](size_t since_version) {
+    std_msgs::UInt64 request;
+    request.data = since_version;
+    map_update_request_pub_.publish(request);
+  });
+  // the map update request or its reply may be lost while the broadcaster connects, so requests are repeated until answered
+  map_update_request_timer_ = nh_.createTimer(ros::Duration(MAP_UPDATE_REQUEST_RETRY_PERIOD), &WMListener::mapUpdateRequestTimerCallback, this);
   map_sub_ = nh_.subscribe("semantic_map", 1, &WMListenerWorker::mapCallback, worker_.get());
   route_sub_ = nh_.subscribe("route", 1, &WMListenerWorker::routeCallback, worker_.get());
   roadway_objects_sub_ = nh_.subscribe("roadway_objects", 1, &WMListenerWorker::roadwayObjectListCallback, worker_.get());
@@ -70,6 +81,18 @@ void WMListener::mapUpdateCallback(const autoware_lanelet2_msgs::MapBinConstPtr&
   worker_->mapUpdateCallback(geofence_msg);
 }
 
+void WMListener::mapUpdateSnapshotCallback(const autoware_lanelet2_msgs::MapBinConstPtr& snapshot_msg)
+{
+  const std::lock_guard<std::mutex> lock(mw_mutex_);
+  worker_->mapUpdateSnapshotCallback(snapshot_msg);
+}
+
+void WMListener::mapUpdateRequestTimerCallback(const ros::TimerEvent& event)
+{
+  const std::lock_guard<std::mutex> lock(mw_mutex_);
+  worker_->resendMapUpdateRequest();
+}
+
 void WMListener::setMapCallback(std::function<void()> callback)
 {
   const std::lock_guard<std::mutex> lock(mw_mutex_);
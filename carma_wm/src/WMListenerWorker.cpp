@@ -15,7 +15,7 @@
  */
 
 #include <lanelet2_extension/utility/message_conversion.h>
-#include "WMListenerWorker.h"
+#include <carma_wm/WMListenerWorker.h>
 
 namespace carma_wm
 {
@@ -45,21 +45,108 @@ void WMListenerWorker::mapCallback(const autoware_lanelet2_msgs::MapBinConstPtr&
 
   world_model_->setMap(new_map);
 
+  // map update versions count from the base map, so any snapshot received before this map no longer applies
+  map_update_version_ = 0;
+  requestMapUpdates(map_update_version_);
+
   // Call user defined map callback
   if (map_callback_)
   {
     map_callback_();
   }
 }
-void WMListenerWorker::mapUpdateCallback(const autoware_lanelet2_msgs::MapBinConstPtr& geofence_msg) const
+void WMListenerWorker::mapUpdateCallback(const autoware_lanelet2_msgs::MapBinConstPtr& geofence_msg)
 {
   // convert ros msg to geofence object
   auto gf_ptr = std::make_shared<carma_wm::TrafficControl>(carma_wm::TrafficControl());
   carma_wm::fromBinMsg(*geofence_msg, gf_ptr);
   ROS_INFO_STREAM("New Map Update Received with Geofence Id:" << gf_ptr->id_);
 
-  ROS_INFO_STREAM("Geofence id" << gf_ptr->id_ << " requests removal of size: " << gf_ptr->remove_list_.size());
-  for (auto pair : gf_ptr->remove_list_)
+  // updates from a broadcaster which does not version them are always applied
+  if (gf_ptr->map_version_ != 0)
+  {
+    if (gf_ptr->map_version_ <= map_update_version_)
+    {
+      ROS_DEBUG_STREAM("Ignoring map update version " << gf_ptr->map_version_ << " as the map is already at version " << map_update_version_);
+      return;
+    }
+    if (gf_ptr->map_version_ > map_update_version_ + 1 && map_update_request_callback_)
+    {
+      // the requested updates are republished in order and include this one
+      ROS_WARN_STREAM("Missed map updates after version " << map_update_version_ << " before version " << gf_ptr->map_version_ << ". Requesting them again");
+      requestMapUpdates(map_update_version_);
+      return;
+    }
+  }
+
+  applyMapUpdate(*gf_ptr);
+  if (gf_ptr->map_version_ != 0)
+  {
+    map_update_version_ = gf_ptr->map_version_;
+    // the republished updates arrive in order so the first one applied answers the request
+    if (map_update_request_pending_ && map_update_version_ > map_update_request_version_)
+      map_update_request_pending_ = false;
+  }
+  ROS_INFO_STREAM("Finished Applying the Map Update with Geofence Id:" << gf_ptr->id_);
+}
+
+void WMListenerWorker::mapUpdateSnapshotCallback(const autoware_lanelet2_msgs::MapBinConstPtr& snapshot_msg)
+{
+  // a snapshot holds changes relative to the base map so it only applies to a map without any updates
+  if (!world_model_->getMap() || map_update_version_ != 0)
+    return;
+
+  auto gf_ptr = std::make_shared<carma_wm::TrafficControl>(carma_wm::TrafficControl());
+  carma_wm::fromBinMsg(*snapshot_msg, gf_ptr);
+  // any snapshot answers the request, including an empty one from a broadcaster which has not published updates yet
+  map_update_request_pending_ = false;
+  if (gf_ptr->map_version_ == 0)
+    return;
+
+  ROS_INFO_STREAM("Applying map update snapshot of version " << gf_ptr->map_version_);
+  applyMapUpdate(*gf_ptr);
+  map_update_version_ = gf_ptr->map_version_;
+}
+
+void WMListenerWorker::requestMapUpdates(size_t since_version)
+{
+  map_update_request_pending_ = true;
+  map_update_request_version_ = since_version;
+  if (map_update_request_callback_)
+  {
+    map_update_request_callback_(since_version);
+  }
+}
+
+void WMListenerWorker::resendMapUpdateRequest()
+{
+  if (!map_update_request_pending_ || !map_update_request_callback_)
+    return;
+
+  ROS_DEBUG_STREAM("No reply to the request for map updates after version " << map_update_request_version_ << ". Requesting them again");
+  map_update_request_callback_(map_update_request_version_);
+}
+
+bool WMListenerWorker::isMapUpdateRequestPending() const
+{
+  return map_update_request_pending_;
+}
+
+void WMListenerWorker::setMapUpdateRequestCallback(std::function<void(size_t)> callback)
+{
+  map_update_request_callback_ = callback;
+}
+
+size_t WMListenerWorker::getMapUpdateVersion() const
+{
+  return map_update_version_;
+}
+
+// helper function that applies the changes of a map update to the map and rebuilds its routing graph
+void WMListenerWorker::applyMapUpdate(const carma_wm::TrafficControl& gf) const
+{
+  ROS_INFO_STREAM("Geofence id" << gf.id_ << " requests removal of size: " << gf.remove_list_.size());
+  for (auto pair : gf.remove_list_)
   {
     auto parent_llt = world_model_->getMutableMap()->laneletLayer.get(pair.first);
     // we can only check by id, if the element is there
@@ -71,10 +158,10 @@ void WMListenerWorker::mapUpdateCallback(const autoware_lanelet2_msgs::MapBinCon
     }
   }
 
-  ROS_INFO_STREAM("Geofence id" << gf_ptr->id_ << " requests update of size: " << gf_ptr->update_list_.size());
+  ROS_INFO_STREAM("Geofence id" << gf.id_ << " requests update of size: " << gf.update_list_.size());
   // we should extract general regem to specific type of regem the geofence specifies
   
-  for (auto pair : gf_ptr->update_list_)
+  for (auto pair : gf.update_list_)
   {
     auto parent_llt = world_model_->getMutableMap()->laneletLayer.get(pair.first);
     auto regemptr_it = world_model_->getMutableMap()->regulatoryElementLayer.find(pair.second->id());
@@ -92,7 +179,6 @@ void WMListenerWorker::mapUpdateCallback(const autoware_lanelet2_msgs::MapBinCon
   
   // set the map to set a new routing
   world_model_->setMap(world_model_->getMutableMap());
-  ROS_INFO_STREAM("Finished Applying the Map Update with Geofence Id:" << gf_ptr->id_);
 }
 
 /*!
@@ -89,6 +89,13 @@ TEST(TrafficControl, TrafficControlBinMsgTest)
   ASSERT_EQ(data_received->update_list_[0].first, gf_ptr->update_list_[0].first);
   ASSERT_NE(data_received->update_list_[0].second, gf_ptr->update_list_[0].second); // they are now not same because of serialization, the data address is different
                                                                                     // but again, they are same elements
+  ASSERT_EQ(data_received->map_version_, 0); // not versioned
+
+  send_data->map_version_ = 42;
+  carma_wm::toBinMsg(send_data, &gf_obj_msg);
+  data_received = std::make_shared<carma_wm::TrafficControl>(carma_wm::TrafficControl());
+  carma_wm::fromBinMsg(gf_obj_msg, data_received);
+  ASSERT_EQ(data_received->map_version_, 42);
 }
 
 }  // namespace carma_wm_ctrl
\ No newline at end of file
@@ -17,7 +17,7 @@
 #include <gmock/gmock.h>
 #include <iostream>
 #include <lanelet2_extension/utility/message_conversion.h>
-#include <../src/WMListenerWorker.h>
+#include <carma_wm/WMListenerWorker.h>
 #include <carma_wm/CARMAWorldModel.h>
 #include <lanelet2_core/geometry/LineString.h>
 #include <lanelet2_traffic_rules/TrafficRulesFactory.h>
@@ -230,6 +230,191 @@ TEST(WMListenerWorkerTest, mapUpdateCallback)
   ASSERT_EQ(wmlw.getWorldModel()->getMap()->laneletLayer.findUsages(regem_old_correct_data)[0].id(), ll_1.id());
 }
 
+TEST(WMListenerWorkerTest, versionedMapUpdates)
+{
+  using namespace lanelet::units::literals;
+  auto p1 = getPoint(0, 0, 0);
+  auto p2 = getPoint(0, 1, 0);
+  auto p3 = getPoint(1, 1, 0);
+  auto p4 = getPoint(1, 0, 0);
+  lanelet::LineString3d left_ls_1(lanelet::utils::getId(), { p1, p2 });
+  lanelet::LineString3d right_ls_1(lanelet::utils::getId(), { p4, p3 });
+  auto ll_1 = getLanelet(left_ls_1, right_ls_1, lanelet::AttributeValueString::SolidSolid,
+                         lanelet::AttributeValueString::Dashed);
+
+  lanelet::DigitalSpeedLimitPtr speed_limit_old = std::make_shared<lanelet::DigitalSpeedLimit>(lanelet::DigitalSpeedLimit::buildData(9000, 5_mph, {ll_1}, {},
+                                                     { lanelet::Participants::VehicleCar }));
+  lanelet::DigitalSpeedLimitPtr speed_limit_new = std::make_shared<lanelet::DigitalSpeedLimit>(lanelet::DigitalSpeedLimit::buildData(9001, 5_mph, {ll_1}, {},
+                                                     { lanelet::Participants::VehicleCar }));
+
+  // updates alternate between the old and new speed limit
+  auto makeUpdate = [&](size_t version, bool to_new) {
+    auto gf_ptr = std::make_shared<carma_wm::TrafficControl>(carma_wm::TrafficControl());
+    gf_ptr->id_ = boost::uuids::random_generator()();
+    gf_ptr->remove_list_.push_back(std::make_pair(ll_1.id(), to_new ? speed_limit_old : speed_limit_new));
+    gf_ptr->update_list_.push_back(std::make_pair(ll_1.id(), to_new ? speed_limit_new : speed_limit_old));
+    gf_ptr->map_version_ = version;
+    autoware_lanelet2_msgs::MapBin msg;
+    carma_wm::toBinMsg(gf_ptr, &msg);
+    return boost::make_shared<const autoware_lanelet2_msgs::MapBin>(msg);
+  };
+  auto currentSpeedLimit = [&](const WMListenerWorker& wmlw) {
+    auto regems = wmlw.getWorldModel()->getMap()->laneletLayer.get(ll_1.id()).regulatoryElements();
+    return regems.size() == 1 ? regems[0]->id() : lanelet::InvalId;
+  };
+
+  ll_1.addRegulatoryElement(speed_limit_old);
+  lanelet::LaneletMapPtr map = lanelet::utils::createMap({ ll_1 }, { });
+  autoware_lanelet2_msgs::MapBin map_msg;
+  lanelet::utils::conversion::toBinMsg(map, &map_msg);
+  autoware_lanelet2_msgs::MapBinConstPtr map_msg_ptr(new autoware_lanelet2_msgs::MapBin(map_msg));
+
+  WMListenerWorker wmlw;
+  std::vector<size_t> requests;
+  wmlw.setMapUpdateRequestCallback([&](size_t since_version) { requests.push_back(since_version); });
+  wmlw.mapCallback(map_msg_ptr);
+  ASSERT_EQ(0, wmlw.getMapUpdateVersion());
+  // every new map requests the snapshot
+  ASSERT_EQ(1, requests.size());
+  ASSERT_EQ(0, requests[0]);
+
+  wmlw.mapUpdateCallback(makeUpdate(1, true));
+  ASSERT_EQ(1, wmlw.getMapUpdateVersion());
+  ASSERT_EQ(speed_limit_new->id(), currentSpeedLimit(wmlw));
+
+  // a repeated update is ignored instead of being applied twice
+  wmlw.mapUpdateCallback(makeUpdate(1, true));
+  ASSERT_EQ(1, wmlw.getMapUpdateVersion());
+  ASSERT_EQ(1, requests.size());
+
+  // an update after a missed one is dropped and the missed updates are requested
+  auto update_3 = makeUpdate(3, true);
+  wmlw.mapUpdateCallback(update_3);
+  ASSERT_EQ(1, wmlw.getMapUpdateVersion());
+  ASSERT_EQ(speed_limit_new->id(), currentSpeedLimit(wmlw));
+  ASSERT_EQ(2, requests.size());
+  ASSERT_EQ(1, requests[1]);
+
+  // the republished updates are applied in order
+  wmlw.mapUpdateCallback(makeUpdate(2, false));
+  wmlw.mapUpdateCallback(update_3);
+  ASSERT_EQ(3, wmlw.getMapUpdateVersion());
+  ASSERT_EQ(speed_limit_new->id(), currentSpeedLimit(wmlw));
+
+  // a snapshot received before the base map is republished does not apply to the updated map
+  wmlw.mapUpdateSnapshotCallback(makeUpdate(3, true));
+  ASSERT_EQ(3, wmlw.getMapUpdateVersion());
+  // the republished base map drops the updates, so the snapshot is requested again and applied on arrival
+  wmlw.mapCallback(map_msg_ptr);
+  ASSERT_EQ(0, wmlw.getMapUpdateVersion());
+  ASSERT_EQ(speed_limit_old->id(), currentSpeedLimit(wmlw));
+  ASSERT_EQ(3, requests.size());
+  ASSERT_EQ(0, requests[2]);
+  wmlw.mapUpdateSnapshotCallback(makeUpdate(3, true));
+  ASSERT_EQ(3, wmlw.getMapUpdateVersion());
+  ASSERT_EQ(speed_limit_new->id(), currentSpeedLimit(wmlw));
+
+  // a late joining listener ignores snapshots until its map arrives
+  WMListenerWorker late_wmlw;
+  late_wmlw.mapUpdateSnapshotCallback(makeUpdate(3, true));
+  late_wmlw.mapCallback(map_msg_ptr);
+  ASSERT_EQ(0, late_wmlw.getMapUpdateVersion());
+  late_wmlw.mapUpdateSnapshotCallback(makeUpdate(3, true));
+  ASSERT_EQ(3, late_wmlw.getMapUpdateVersion());
+  ASSERT_EQ(speed_limit_new->id(), currentSpeedLimit(late_wmlw));
+
+  // snapshots do not apply once the map has been updated
+  late_wmlw.mapUpdateCallback(makeUpdate(4, false));
+  late_wmlw.mapUpdateSnapshotCallback(makeUpdate(5, true));
+  ASSERT_EQ(4, late_wmlw.getMapUpdateVersion());
+  ASSERT_EQ(speed_limit_old->id(), currentSpeedLimit(late_wmlw));
+}
+
+TEST(WMListenerWorkerTest, lostMapUpdateRequest)
+{
+  using namespace lanelet::units::literals;
+  auto p1 = getPoint(0, 0, 0);
+  auto p2 = getPoint(0, 1, 0);
+  auto p3 = getPoint(1, 1, 0);
+  auto p4 = getPoint(1, 0, 0);
+  lanelet::LineString3d left_ls_1(lanelet::utils::getId(), { p1, p2 });
+  lanelet::LineString3d right_ls_1(lanelet::utils::getId(), { p4, p3 });
+  auto ll_1 = getLanelet(left_ls_1, right_ls_1, lanelet::AttributeValueString::SolidSolid,
+                         lanelet::AttributeValueString::Dashed);
+
+  lanelet::DigitalSpeedLimitPtr speed_limit_old = std::make_shared<lanelet::DigitalSpeedLimit>(lanelet::DigitalSpeedLimit::buildData(9010, 5_mph, {ll_1}, {},
+                                                     { lanelet::Participants::VehicleCar }));
+  lanelet::DigitalSpeedLimitPtr speed_limit_new = std::make_shared<lanelet::DigitalSpeedLimit>(lanelet::DigitalSpeedLimit::buildData(9011, 5_mph, {ll_1}, {},
+                                                     { lanelet::Participants::VehicleCar }));
+
+  // updates alternate between the old and new speed limit. A snapshot without changes has version 0
+  auto makeUpdate = [&](size_t version, bool to_new) {
+    auto gf_ptr = std::make_shared<carma_wm::TrafficControl>(carma_wm::TrafficControl());
+    gf_ptr->id_ = boost::uuids::random_generator()();
+    if (version != 0)
+    {
+      gf_ptr->remove_list_.push_back(std::make_pair(ll_1.id(), to_new ? speed_limit_old : speed_limit_new));
+      gf_ptr->update_list_.push_back(std::make_pair(ll_1.id(), to_new ? speed_limit_new : speed_limit_old));
+    }
+    gf_ptr->map_version_ = version;
+    autoware_lanelet2_msgs::MapBin msg;
+    carma_wm::toBinMsg(gf_ptr, &msg);
+    return boost::make_shared<const autoware_lanelet2_msgs::MapBin>(msg);
+  };
+
+  ll_1.addRegulatoryElement(speed_limit_old);
+  lanelet::LaneletMapPtr map = lanelet::utils::createMap({ ll_1 }, { });
+  autoware_lanelet2_msgs::MapBin map_msg;
+  lanelet::utils::conversion::toBinMsg(map, &map_msg);
+  autoware_lanelet2_msgs::MapBinConstPtr map_msg_ptr(new autoware_lanelet2_msgs::MapBin(map_msg));
+
+  WMListenerWorker wmlw;
+  std::vector<size_t> requests;
+  wmlw.setMapUpdateRequestCallback([&](size_t since_version) { requests.push_back(since_version); });
+
+  // nothing to repeat before a request is made
+  wmlw.resendMapUpdateRequest();
+  ASSERT_EQ(0, requests.size());
+
+  // the snapshot request sent with the map is lost, so it is repeated until the snapshot arrives
+  wmlw.mapCallback(map_msg_ptr);
+  ASSERT_EQ(1, requests.size());
+  ASSERT_TRUE(wmlw.isMapUpdateRequestPending());
+  wmlw.resendMapUpdateRequest();
+  wmlw.resendMapUpdateRequest();
+  ASSERT_EQ(3, requests.size());
+  ASSERT_EQ(0, requests[2]);
+
+  wmlw.mapUpdateSnapshotCallback(makeUpdate(2, true));
+  ASSERT_EQ(2, wmlw.getMapUpdateVersion());
+  ASSERT_FALSE(wmlw.isMapUpdateRequestPending());
+  wmlw.resendMapUpdateRequest();
+  ASSERT_EQ(3, requests.size());
+
+  // the republished updates are lost, so the missed updates are requested again until the first of them arrives
+  auto update_4 = makeUpdate(4, true);
+  wmlw.mapUpdateCallback(update_4);
+  ASSERT_EQ(4, requests.size());
+  ASSERT_EQ(2, requests[3]);
+  wmlw.resendMapUpdateRequest();
+  ASSERT_EQ(5, requests.size());
+  ASSERT_EQ(2, requests[4]);
+
+  wmlw.mapUpdateCallback(makeUpdate(3, false));
+  ASSERT_FALSE(wmlw.isMapUpdateRequestPending());
+  wmlw.mapUpdateCallback(update_4);
+  ASSERT_EQ(4, wmlw.getMapUpdateVersion());
+  wmlw.resendMapUpdateRequest();
+  ASSERT_EQ(5, requests.size());
+
+  // an empty snapshot from a broadcaster without updates also answers the request
+  wmlw.mapCallback(map_msg_ptr);
+  ASSERT_TRUE(wmlw.isMapUpdateRequestPending());
+  wmlw.mapUpdateSnapshotCallback(makeUpdate(0, true));
+  ASSERT_FALSE(wmlw.isMapUpdateRequestPending());
+  ASSERT_EQ(0, wmlw.getMapUpdateVersion());
+}
+
 TEST(WMListenerWorkerTest, setConfigSpeedLimitTest)
 {
   WMListenerWorker wmlw;
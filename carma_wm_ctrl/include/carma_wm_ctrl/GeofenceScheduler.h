@@ -18,7 +18,10 @@
 #include <ros/time.h>
 #include <mutex>
 #include <memory>
+#include <map>
 #include <unordered_map>
+#include <vector>
+#include <boost/functional/hash.hpp>
 #include <carma_wm_ctrl/Geofence.h>
 #include <carma_utils/timers/Timer.h>
 #include <carma_utils/timers/TimerFactory.h>
@@ -28,6 +31,11 @@ namespace carma_wm_ctrl
 /**
  * @brief A GeofenceScheduler is responsable for notifying the user when a geofence is active or inactive according to
  * its schedule
+ *
+ * The next start or end of every geofence schedule is kept in a single queue ordered by trigger time and only the
+ * earliest one is backed by a timer. Adding or cancelling a geofence is O(log n) in the number of pending transitions
+ * and all transitions which are due when the timer fires are handled together. The active and inactive callbacks are
+ * called without holding the scheduler lock.
  */
 class GeofenceScheduler
 {
@@ -35,13 +43,29 @@ class GeofenceScheduler
   using TimerFactory = carma_utils::timers::TimerFactory;
   using TimerPtr = std::unique_ptr<Timer>;
 
+  // The start or end of a control period of one of the schedules of a geofence
+  struct Transition
+  {
+    std::shared_ptr<Geofence> gf_ptr;
+    unsigned int schedule_id;
+    bool is_start;
+  };
+  using TransitionKey = std::pair<ros::Time, uint32_t>;  // Trigger time and transition id
+
   std::mutex mutex_;
   std::unique_ptr<TimerFactory> timerFactory_;
-  std::unordered_map<uint32_t, std::pair<TimerPtr, bool>> timers_;  // Pairing of timers with their Id and valid status
+  std::map<TransitionKey, Transition> transitions_;  // Pending transitions ordered by trigger time
+  std::unordered_map<boost::uuids::uuid, std::vector<TransitionKey>, boost::hash<boost::uuids::uuid>>
+      geofence_transitions_;  // Keys of the pending transitions of each geofence
+  TimerPtr transition_timer_;  // Timer for the earliest pending transition
+  uint32_t transition_timer_id_ = 0;
+  ros::Time transition_timer_time_;
+  std::vector<TimerPtr> retired_timers_;  // Replaced transition timers which may still be inside their callback
+  bool processing_transitions_ = false;  // True while the transition timer callback is triggering transitions
   std::unique_ptr<Timer> deletion_timer_;
   std::function<void(std::shared_ptr<Geofence>)> active_callback_;
   std::function<void(std::shared_ptr<Geofence>)> inactive_callback_;
-  uint32_t next_id_ = 0;  // Timer id counter
+  uint32_t next_id_ = 0;  // Timer and transition id counter
 
 public:
   /**
@@ -57,8 +81,18 @@ public:
    * inactive according to its schedule
    *
    * @param geofence The geofence to be added
+   *
+   * @return True if the geofence is active now, in which case the active callback is triggered as soon as possible
    */
-  void addGeofence(std::shared_ptr<Geofence> gf_ptr);
+  bool addGeofence(std::shared_ptr<Geofence> gf_ptr);
+
+  /**
+   * @brief Cancel the pending transitions of a geofence. If the geofence is currently active the inactive callback is
+   * triggered immediately. Does nothing if the geofence has no pending transitions
+   *
+   * @param gf_id The id of the geofence to cancel
+   */
+  void removeGeofence(const boost::uuids::uuid& gf_id);
 
   /**
    * @brief Method which allows the user to set a callback which will be triggered when a geofence becomes active
@@ -74,37 +108,48 @@ public:
   void onGeofenceInactive(std::function<void(std::shared_ptr<Geofence>)> inactive_callback);
 
   /**
-   * @brief Clears the expired timers from the memory of this scheduler
+   * @brief Clears the replaced timers from the memory of this scheduler
    */
   void clearTimers();
 
 private:
   /**
-   * @brief Generates the next id to be used for a timer
+   * @brief Generates the next id to be used for a timer or transition
    *
-   * @return The next available timer id
+   * @return The next available id
    */
   uint32_t nextId();
 
   /**
-   * @brief The callback which is triggered when a geofence becomes active
-   *        This will call the user set active_callback set from the onGeofenceActive function
+   * @brief Queues a transition of a geofence schedule
    *
-   * @param event The record of the timer event causing this to trigger
-   * @param gf The geofence which is being activated
-   * @param schedule_id index number of the schedule being used corresponding to this geofence
-   * @param timer_id The id of the timer which caused this callback to occur
+   * @param time The time at which the transition should trigger
+   * @param transition The transition to queue
    */
-  void startGeofenceCallback(const ros::TimerEvent& event, std::shared_ptr<Geofence> gf_ptr, const unsigned int schedule_id, const int32_t timer_id);
+  void pushTransition(const ros::Time& time, const Transition& transition);
+
+  /**
+   * @brief Makes sure the transition timer triggers at the time of the earliest pending transition
+   *
+   * @param now The current time
+   */
+  void armTimer(const ros::Time& now);
+
   /**
-   * @brief The callback which is triggered when a geofence becomes in-active
-   *        This will call the user set inactive_callback set from the onGeofenceInactive function
+   * @brief The callback of the transition timer. Triggers every transition which is due
    *
    * @param event The record of the timer event causing this to trigger
-   * @param gf The geofence which is being un-activated
-   * @param schedule_id index number of the schedule being used corresponding to this geofence
    * @param timer_id The id of the timer which caused this callback to occur
    */
-  void endGeofenceCallback(const ros::TimerEvent& event, std::shared_ptr<Geofence> gf_ptr, const unsigned int schedule_id, const int32_t timer_id);
+  void transitionCallback(const ros::TimerEvent& event, const uint32_t timer_id);
+
+  /**
+   * @brief Queues the transition which follows a triggered one. The end of the control period follows a start and the
+   *        start of the next control period, if there is one, follows an end
+   *
+   * @param transition The transition which was triggered
+   * @param now The current time
+   */
+  void queueNextTransition(const Transition& transition, const ros::Time& now);
 };
 }  // namespace carma_wm_ctrl
\ No newline at end of file
@@ -23,7 +23,10 @@
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/date_time/date_defs.hpp>
 #include <boost/icl/interval_set.hpp>
+#include <set>
+#include <deque>
 #include <unordered_set>
+#include <unordered_map>
 #include "ros/ros.h"
 #include <lanelet2_core/LaneletMap.h>
 #include <lanelet2_core/geometry/Lanelet.h>
@@ -50,7 +53,10 @@
 #include <cav_msgs/CheckActiveGeofence.h>
 #include <carma_wm/TrafficControl.h>
 #include <std_msgs/String.h>
+#include <std_msgs/UInt64.h>
 #include <unordered_set>
+#include <boost/functional/hash.hpp>
+#include <proj.h>
 
 namespace carma_wm_ctrl
 {
@@ -101,6 +107,18 @@ public:
    */
   void geofenceCallback(const cav_msgs::TrafficControlMessage& geofence_msg);
 
+  /*!
+   * \brief Callback to add a batch of geofences to the map. Currently only supports version 1 TrafficControlMessage
+   *
+   * The lanelet matching and geofence conversion of the batch run in parallel without holding the map lock.
+   * The resulting geofences are then scheduled in one critical section. Geofences of the batch which are
+   * already active are published together as one map update once all of them have been applied.
+   *
+   * \param geofence_msgs The ROS msgs of the geofences to add
+   * \throw InvalidObjectStateError if base_map is not set or the base_map's georeference is empty
+   */
+  void geofenceBatchCallback(const std::vector<cav_msgs::TrafficControlMessage>& geofence_msgs);
+
   /*!
    * \brief Adds a geofence to the current map and publishes the ROS msg
    */
@@ -110,6 +128,47 @@ public:
    * \brief Removes a geofence from the current map and publishes the ROS msg
    */
   void removeGeofence(std::shared_ptr<Geofence> gf_ptr);
+
+  /*!
+   * \brief Sets whether map updates are held until flushMapUpdates is called instead of being published as each geofence
+   *        activates or deactivates. Disabling coalescing publishes any held changes
+   *
+   * \param coalesce If true the changes of all geofences activated or deactivated between flushes are published as one update
+   */
+  void setMapUpdateCoalescing(bool coalesce);
+
+  /*!
+   * \brief Publishes the map changes held since the last update as one ROS msg. Changes which cancel out are dropped.
+   *        Does nothing if no geofence was activated or deactivated since the last update
+   */
+  void flushMapUpdates();
+
+  /*!
+   * \brief Sets the callback used to publish the compacted snapshot of all map updates when a listener requests it
+   *
+   * The snapshot holds the net changes of every update published since the base map was loaded and carries the version
+   * of the last one, so a listener which receives the base map can apply it instead of every past update
+   *
+   * \param map_update_snapshot_pub The callback which publishes the snapshot
+   */
+  void onMapUpdateSnapshot(const PublishMapUpdateCallback& map_update_snapshot_pub);
+
+  /*!
+   * \brief Sets the number of published map updates kept to be republished to listeners which missed them
+   *
+   * \param log_size The number of most recent updates kept
+   */
+  void setMapUpdateLogSize(size_t log_size);
+
+  /*!
+   * \brief Callback for listeners requesting the map updates published after a version they have applied
+   *
+   * A listener which has applied no update is sent the snapshot. Otherwise the logged updates are republished in order
+   * if they reach back to the requested version, or the base map is republished if they do not
+   *
+   * \param since_version The version of the last map update the requesting listener applied
+   */
+  void mapUpdateRequestCallback(const std_msgs::UInt64& since_version);
   
   /*!
   * \brief Calls controlRequestFromRoute() and publishes the TrafficControlRequest Message returned after the completed operations
@@ -155,7 +214,7 @@ public:
   std::shared_ptr<Geofence> geofenceFromMsg(const cav_msgs::TrafficControlMessageV01& geofence_msg);
 
   /*!
-   * \brief Returns the route distance (downtrack or crosstrack in meters) to the nearest active geofence lanelet
+   * \brief Returns the route downtrack distance in meters to the start of the next active geofence lanelet on the route
    * \param curr_pos Current position in local coordinates
    * \throw InvalidObjectStateError if base_map is not set
    * \throw std::invalid_argument if curr_pos is not on the road
@@ -176,21 +235,63 @@ public:
 
 
 private:
+  // Geometry of a lanelet which is used to match geofence points
+  struct LaneletMatchGeometry
+  {
+    lanelet::Lanelet llt;
+    lanelet::BasicPolygon2d polygon;
+    lanelet::BoundingBox2d box;
+    lanelet::BasicLineString2d end_line;  // connects the last points of the left and right bounds
+    lanelet::BasicPoint2d end_median;  // midpoint of end_line
+  };
+  // The tables used to match geofences to the lanelets of one base map, built once per base map and never modified.
+  // Geofences only change speed limits and passing control lines, which never alter the geometry or successor relations
+  struct GeofenceMatchTables
+  {
+    lanelet::LaneletMapPtr map;
+    // Successors of each lanelet of map
+    std::unordered_map<lanelet::Id, lanelet::Ids> successor_table;
+    // Geometry of each lanelet of map
+    std::unordered_map<lanelet::Id, LaneletMatchGeometry> lanelet_match_geometry;
+  };
   lanelet::ConstLanelets route_path_;
+  // Map view of route_path_ used to project positions off the route onto it
+  lanelet::LaneletMapConstPtr route_view_;
   std::unordered_set<lanelet::Id> active_geofence_llt_ids_; 
+  // Route downtrack at which each lanelet of route_path_ starts
+  std::unordered_map<lanelet::Id, double> route_llt_downtracks_;
+  // Active geofence lanelets on route_path_ sorted by the route downtrack at which they start
+  std::set<std::pair<double, lanelet::Id>> active_geofence_downtracks_;
+  double distToNextActiveGeofence(const lanelet::ConstLanelet& curr_llt, const lanelet::BasicPoint2d& curr_pos) const;
+  void updateActiveGeofenceIndex(lanelet::Id llt_id, bool active);
   void addRegulatoryComponent(std::shared_ptr<Geofence> gf_ptr) const;
   void addBackRegulatoryComponent(std::shared_ptr<Geofence> gf_ptr) const;
   void removeGeofenceHelper(std::shared_ptr<Geofence> gf_ptr) const;
   void addGeofenceHelper(std::shared_ptr<Geofence> gf_ptr) const;
   bool shouldChangeControlLine(const lanelet::ConstLaneletOrArea& el,const lanelet::RegulatoryElementConstPtr& regem, std::shared_ptr<Geofence> gf_ptr) const;
   void addPassingControlLineFromMsg(std::shared_ptr<Geofence> gf_ptr, const cav_msgs::TrafficControlMessageV01& msg_v01, const std::vector<lanelet::Lanelet>& affected_llts) const; 
-  std::unordered_set<lanelet::Lanelet> filterSuccessorLanelets(const std::unordered_set<lanelet::Lanelet>& possible_lanelets, const std::unordered_set<lanelet::Lanelet>& root_lanelets);
+  std::unordered_set<lanelet::Lanelet> filterSuccessorLanelets(const GeofenceMatchTables& tables, const std::unordered_set<lanelet::Lanelet>& possible_lanelets, const std::unordered_set<lanelet::Lanelet>& root_lanelets) const;
+  void buildSuccessorTable(GeofenceMatchTables& tables) const;
+  void buildLaneletMatchGeometry(GeofenceMatchTables& tables) const;
+  PJ* getGeofenceProjection(const std::string& geofence_proj);
+  bool acceptGeofenceMsg(const cav_msgs::TrafficControlMessage& geofence_msg);
+  std::string geofenceMsgId(const cav_msgs::TrafficControlMessageV01& msg_v01) const;
+  std::string geofenceMsgId(const cav_msgs::TrafficControlMessage& geofence_msg) const;
+  std::vector<lanelet::Point3d> geofencePointsInMap(const cav_msgs::TrafficControlMessageV01& tcmV01);
+  lanelet::ConstLaneletOrAreas matchAffectedLaneletOrAreas(const GeofenceMatchTables& tables, const std::vector<lanelet::Point3d>& gf_pts) const;
+  std::shared_ptr<Geofence> geofenceFromMsg(const cav_msgs::TrafficControlMessageV01& msg_v01, const lanelet::ConstLaneletOrAreas& affected_parts,
+                                            const lanelet::LaneletMapPtr& map) const;
+  void queueMapUpdate(std::shared_ptr<Geofence> gf_ptr);
+  void publishPendingMapUpdate();
+  void publishMapUpdateSnapshot();
   lanelet::LaneletMapPtr base_map_;
   lanelet::LaneletMapPtr current_map_;
   lanelet::Velocity config_limit;
   std::unordered_set<std::string>  checked_geofence_ids_;
   std::unordered_set<std::string>  generated_geofence_reqids_;
   std::vector<lanelet::LaneletMapPtr> cached_maps_;
+  // Tables of current_map_ used to match geofences, replaced as a whole by each base map
+  std::shared_ptr<const GeofenceMatchTables> match_tables_;
   std::mutex map_mutex_;
   PublishMapCallback map_pub_;
   PublishMapUpdateCallback map_update_pub_;
@@ -198,7 +299,42 @@ private:
   PublishActiveGeofCallback active_pub_;
   GeofenceScheduler scheduler_;
   std::string base_map_georef_;
-  double max_lane_width_;
+  // Transformations from geofence projections to base_map_georef_ keyed by the geofence proj string. Cleared when the georeference changes
+  std::unordered_map<std::string, std::shared_ptr<PJ>> geofence_projections_;
+  // Projector of base_map_georef_ used to convert route bounds to lat/lon. Reset when the georeference changes
+  std::unique_ptr<lanelet::projection::LocalFrameProjector> local_projector_;
+  // Ids of geofences from a batch which the scheduler reported active when scheduled but have not been applied yet.
+  // The changes of the applied ones are held back until the rest are applied, a flush or a new base map
+  std::unordered_set<std::string> pending_batch_ids_;
+  // The net change made to a lanelet and regulatory element pair over a series of map changes
+  struct PendingMapChange
+  {
+    std::pair<lanelet::Id, lanelet::RegulatoryElementPtr> change;
+    bool first_remove;  // true if the first change to this pair in the series was a removal
+    bool remove;  // true if the latest change to this pair was a removal
+  };
+  using MapChangeIndex = std::unordered_map<std::pair<lanelet::Id, lanelet::Id>, size_t, boost::hash<std::pair<lanelet::Id, lanelet::Id>>>;
+  static void recordMapChange(std::vector<PendingMapChange>& changes, MapChangeIndex& change_index,
+                              const std::pair<lanelet::Id, lanelet::RegulatoryElementPtr>& change, bool remove);
+  static void addNetMapChanges(const std::vector<PendingMapChange>& changes, carma_wm::TrafficControl& update);
+  // Pending changes with one entry per lanelet and regulatory element id pair, indexed by that pair
+  std::vector<PendingMapChange> pending_changes_;
+  MapChangeIndex pending_change_index_;
+  std::vector<boost::uuids::uuid> pending_geofence_ids_;
+  bool coalesce_map_updates_ = false;
+  // Net changes of every update published since the base map was loaded, which make up the compacted snapshot
+  std::vector<PendingMapChange> published_changes_;
+  MapChangeIndex published_change_index_;
+  // Version of the last published update. Counts the updates published since the base map was loaded
+  size_t map_update_version_ = 0;
+  // The last published updates, oldest first, ending with version map_update_version_
+  std::deque<autoware_lanelet2_msgs::MapBin> map_update_log_;
+  size_t map_update_log_size_ = 100;
+  PublishMapUpdateCallback map_update_snapshot_pub_;
+  // The last serialized snapshot, valid until the next update is published
+  autoware_lanelet2_msgs::MapBin snapshot_msg_;
+  bool snapshot_msg_valid_ = false;
+  double max_lane_width_ = 4.0;
   
 
 };
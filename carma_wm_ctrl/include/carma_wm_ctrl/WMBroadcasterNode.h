@@ -19,6 +19,7 @@
 #include <functional>
 #include <autoware_lanelet2_msgs/MapBin.h>
 #include <cav_msgs/TrafficControlRequest.h>
+#include <cav_msgs/TrafficControlMessage.h>
 #include <carma_utils/CARMAUtils.h>
 #include <carma_wm_ctrl/WMBroadcaster.h>
 #include <ros/ros.h>
@@ -69,6 +70,13 @@ public:
    */
   void publishMapUpdate(const autoware_lanelet2_msgs::MapBin& geofence_msg) const;
 
+  /**
+   * @brief Callback to publish the compacted snapshot of all map updates since the base map
+   *
+   * @param snapshot_msg The snapshot message to publish
+   */
+  void publishMapUpdateSnapshot(const autoware_lanelet2_msgs::MapBin& snapshot_msg) const;
+
    /**
    * @brief Callback to publish active geofence information
    *
@@ -76,6 +84,27 @@ public:
    */
   void publishActiveGeofence(const cav_msgs::CheckActiveGeofence& active_geof_msg);
 
+  /**
+   * @brief Callback to hold a received geofence until the next batch is ingested. Used when geofence_batch_window is set
+   *
+   * @param geofence_msg The geofence message to buffer
+   */
+  void bufferGeofence(const cav_msgs::TrafficControlMessage& geofence_msg);
+
+  /**
+   * @brief Timer callback which passes the buffered geofences to the WMBroadcaster as one batch
+   *
+   * @param event The record of the timer event causing this to trigger
+   */
+  void flushGeofenceBatch(const ros::TimerEvent& event);
+
+  /**
+   * @brief Timer callback which publishes the map changes coalesced since the last call. Used when map_update_coalesce_window is set
+   *
+   * @param event The record of the timer event causing this to trigger
+   */
+  void flushMapUpdates(const ros::TimerEvent& event);
+
 
 private:
   ros::CARMANodeHandle cnh_;
@@ -85,6 +114,7 @@ private:
 
   ros::Publisher map_pub_;
   ros::Publisher map_update_pub_;
+  ros::Publisher map_update_snapshot_pub_;
   ros::Publisher control_msg_pub_;
 
   ros::Publisher active_pub_;
@@ -97,6 +127,11 @@ private:
   ros::Subscriber georef_sub_;
   ros::Subscriber geofence_sub_;
   ros::Subscriber curr_location_sub_;
+  ros::Subscriber map_update_request_sub_;
+
+  ros::Timer geofence_batch_timer_;
+  ros::Timer map_update_timer_;
+  std::vector<cav_msgs::TrafficControlMessage> geofence_batch_;
 
   WMBroadcaster wmb_;
 };
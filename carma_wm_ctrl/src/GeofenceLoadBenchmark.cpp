@@ -0,0 +1,414 @@
+/*
+ * Copyright (C) 2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <algorithm>
+#include <unistd.h>
+#include <ros/ros.h>
+#include <boost/uuid/uuid_generators.hpp>
+#include <lanelet2_core/LaneletMap.h>
+#include <lanelet2_extension/utility/message_conversion.h>
+#include <carma_wm/WMListenerWorker.h>
+#include <carma_utils/timers/testing/TestTimerFactory.h>
+#include <cav_msgs/Route.h>
+#include <cav_msgs/TrafficControlMessage.h>
+#include <carma_wm_ctrl/WMBroadcaster.h>
+
+/*!
+ * Offline load benchmark for geofence handling in carma_wm_ctrl
+ *
+ * Builds a synthetic straight multi-lane grid map, along the lines of the carma_wm guidance test map,
+ * and feeds it randomly placed and scheduled speed limit geofences through a WMBroadcaster.
+ * The geofences are ingested once per message, once as a single batch and once per message with map update
+ * coalescing enabled. Simulated time is then stepped through the geofence schedules so every activation and
+ * deactivation is published. A WMListenerWorker applies the published updates as a world model listener would.
+ *
+ * One CSV row is written per mode and step. Step 0 is the ingestion at the simulation start and holds the ingestion
+ * time and the resident memory held by the scheduled geofences. Every step reports the map updates published during it
+ * and the time the listener spent applying them and rebuilding its routing graph.
+ *
+ * Usage: geofence_load_benchmark <output_csv> [geofence_count=1000] [lanes=4] [segments=200] [active_ratio=0.5] [seed=0]
+ */
+
+namespace
+{
+using carma_utils::timers::testing::TestTimerFactory;
+
+constexpr double LANE_WIDTH = 3.7;
+constexpr double SEGMENT_LENGTH = 25.0;
+constexpr int MAX_GEOFENCE_SEGMENTS = 10;
+constexpr double MAX_START_DELAY = 3600.0;
+constexpr double MAX_CONTROL_SPAN = 1800.0;
+constexpr double SCHEDULE_STEP = 300.0;
+constexpr double CONFIG_SPEED_LIMIT_MPH = 80.0;
+const ros::Time SIM_START(1000);  // Early in the first simulated day so the daily schedules below apply
+const std::string PROJ_STRING = "+proj=tmerc +lat_0=39.46636844371259 +lon_0=-76.16919523566943 +k=1 +x_0=0 +y_0=0 "
+                                "+datum=WGS84 +units=m +vunits=m +no_defs";
+
+/*!
+ * \brief Results of one simulated time step of one WMBroadcaster configuration
+ */
+struct StepResult
+{
+  ros::Time sim_time;
+  double ingest_ms = 0;
+  long rss_delta_kb = 0;
+  size_t map_update_count = 0;
+  size_t map_update_bytes = 0;
+  size_t max_map_update_bytes = 0;
+  double listener_apply_ms = 0;
+};
+
+/*!
+ * \brief Build a straight grid map of lanes x segments lanelets. Lanes run along +y and neighbouring lanes share bounds
+ * \param route_ids Set to the lanelet ids of the leftmost lane in driving order
+ */
+lanelet::LaneletMapPtr buildGridMap(int lanes, int segments, std::vector<lanelet::Id>& route_ids)
+{
+  // bounds[l][s] is the boundary of lane l on its left side for segment s
+  std::vector<std::vector<lanelet::LineString3d>> bounds(lanes + 1);
+  for (int l = 0; l <= lanes; l++)
+  {
+    lanelet::Point3d prev_pt(lanelet::utils::getId(), l * LANE_WIDTH, 0, 0);
+    for (int s = 0; s < segments; s++)
+    {
+      lanelet::Point3d next_pt(lanelet::utils::getId(), l * LANE_WIDTH, (s + 1) * SEGMENT_LENGTH, 0);
+      lanelet::LineString3d ls(lanelet::utils::getId(), { prev_pt, next_pt });
+      ls.attributes()[lanelet::AttributeName::Type] = lanelet::AttributeValueString::LineThin;
+      ls.attributes()[lanelet::AttributeName::Subtype] =
+          (l == 0 || l == lanes) ? lanelet::AttributeValueString::Solid : lanelet::AttributeValueString::Dashed;
+      bounds[l].push_back(ls);
+      prev_pt = next_pt;
+    }
+  }
+
+  std::vector<lanelet::Lanelet> llts;
+  llts.reserve(lanes * segments);
+  route_ids.clear();
+  for (int l = 0; l < lanes; l++)
+  {
+    for (int s = 0; s < segments; s++)
+    {
+      lanelet::Lanelet ll(lanelet::utils::getId(), bounds[l][s], bounds[l + 1][s]);
+      ll.attributes()[lanelet::AttributeName::Type] = lanelet::AttributeValueString::Lanelet;
+      ll.attributes()[lanelet::AttributeName::Subtype] = lanelet::AttributeValueString::Road;
+      ll.attributes()[lanelet::AttributeName::Location] = lanelet::AttributeValueString::Urban;
+      ll.attributes()[lanelet::AttributeName::OneWay] = "yes";
+      ll.attributes()[lanelet::AttributeName::Dynamic] = "no";
+      ll.attributes()[lanelet::AttributeNamesString::ParticipantVehicle] = "yes";
+      llts.push_back(ll);
+      if (l == 0)
+        route_ids.push_back(ll.id());
+    }
+  }
+  return lanelet::utils::createMap(llts, {});
+}
+
+/*!
+ * \brief Generate speed limit geofences covering 1 to MAX_GEOFENCE_SEGMENTS consecutive segments of a random lane
+ *
+ * A geofence is active at SIM_START with probability active_ratio. The others become active within MAX_START_DELAY
+ * of it. Every geofence stays active for at most MAX_CONTROL_SPAN.
+ * \param active_count Set to the number of geofences which are active at SIM_START
+ */
+std::vector<cav_msgs::TrafficControlMessage> generateGeofences(int count, int lanes, int segments, double active_ratio,
+                                                               const j2735_msgs::Id64b& reqid, std::mt19937& rng,
+                                                               int& active_count)
+{
+  std::uniform_int_distribution<int> lane_dist(0, lanes - 1);
+  std::uniform_int_distribution<int> segment_dist(0, segments - 1);
+  std::uniform_int_distribution<int> length_dist(1, MAX_GEOFENCE_SEGMENTS);
+  std::uniform_real_distribution<double> speed_dist(5.0, 30.0);
+  std::uniform_real_distribution<double> delay_dist(10.0, MAX_START_DELAY);
+  std::uniform_real_distribution<double> span_dist(60.0, MAX_CONTROL_SPAN);
+  std::bernoulli_distribution active_dist(active_ratio);
+  boost::uuids::basic_random_generator<std::mt19937> uuid_gen(&rng);
+
+  std::vector<cav_msgs::TrafficControlMessage> msgs;
+  msgs.reserve(count);
+  active_count = 0;
+  for (int i = 0; i < count; i++)
+  {
+    cav_msgs::TrafficControlMessage msg;
+    msg.choice = cav_msgs::TrafficControlMessage::TCMV01;
+    cav_msgs::TrafficControlMessageV01& msg_v01 = msg.tcmV01;
+
+    boost::uuids::uuid id = uuid_gen();
+    std::copy(id.begin(), id.end(), msg_v01.id.id.begin());
+    msg_v01.reqid = reqid;
+
+    // two nodes per segment along the lane centerline so every geofence has a direction
+    msg_v01.geometry.proj = PROJ_STRING;
+    int lane = lane_dist(rng);
+    int start_segment = segment_dist(rng);
+    int end_segment = std::min(segments, start_segment + length_dist(rng));
+    for (int s = start_segment; s < end_segment; s++)
+    {
+      for (double fraction : { 0.25, 0.75 })
+      {
+        cav_msgs::PathNode pt;
+        pt.x = (lane + 0.5) * LANE_WIDTH;
+        pt.y = (s + fraction) * SEGMENT_LENGTH;
+        pt.z = 0;
+        msg_v01.geometry.nodes.push_back(pt);
+      }
+    }
+
+    msg_v01.params.detail.choice = cav_msgs::TrafficControlDetail::MAXSPEED_CHOICE;
+    msg_v01.params.detail.maxspeed = speed_dist(rng);
+
+    // a single control window each day, starting at SIM_START or a random time after it
+    bool active = active_dist(rng);
+    double control_start = active ? 0.0 : SIM_START.toSec() + delay_dist(rng);
+    double control_span = active ? SIM_START.toSec() + span_dist(rng) : span_dist(rng);
+    msg_v01.params.schedule.start = ros::Time(0);
+    msg_v01.params.schedule.end = ros::Time(86400);
+    cav_msgs::DailySchedule daily_schedule;
+    daily_schedule.begin = ros::Duration(0);
+    daily_schedule.duration = ros::Duration(86399);
+    msg_v01.params.schedule.between.push_back(daily_schedule);
+    msg_v01.params.schedule.repeat.offset = ros::Duration(control_start);
+    msg_v01.params.schedule.repeat.span = ros::Duration(control_span);
+    msg_v01.params.schedule.repeat.period = ros::Duration(86400);
+
+    active_count += active ? 1 : 0;
+    msgs.push_back(msg);
+  }
+  return msgs;
+}
+
+/*!
+ * \brief Resident set size of this process in kilobytes, or 0 if it is not available
+ */
+long residentSetKb()
+{
+  std::ifstream statm("/proc/self/statm");
+  long total_pages = 0;
+  long resident_pages = 0;
+  if (!(statm >> total_pages >> resident_pages))
+  {
+    return 0;
+  }
+  return resident_pages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/*!
+ * \brief Wait until no map update has been published for a while. Activations are published from timer threads
+ */
+void waitForMapUpdatesToSettle(const std::atomic<size_t>& update_count)
+{
+  size_t last_count;
+  do
+  {
+    last_count = update_count.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  } while (update_count.load() != last_count);
+}
+
+/*!
+ * \brief Ingest the geofences into a new WMBroadcaster then step simulated time through their schedules
+ *
+ * The map updates published during each step are applied by a WMListenerWorker before the next step.
+ * \param mode One of per_message, batch or coalesced
+ * \return The results of each step. The first one is the ingestion at SIM_START
+ */
+std::vector<StepResult> runMode(const std::string& mode, const lanelet::LaneletMapPtr& map,
+                                const std::vector<lanelet::Id>& route_ids, int count, int lanes, int segments,
+                                double active_ratio, unsigned seed)
+{
+  ros::Time::setNow(SIM_START);
+
+  autoware_lanelet2_msgs::MapBin published_map;
+  std::vector<autoware_lanelet2_msgs::MapBin> map_updates;
+  std::mutex update_mutex;
+  std::atomic<size_t> update_count(0);
+
+  carma_wm_ctrl::WMBroadcaster wmb(
+      [&](const autoware_lanelet2_msgs::MapBin& map_bin) { published_map = map_bin; },
+      [&](const autoware_lanelet2_msgs::MapBin& update_bin) {
+        std::lock_guard<std::mutex> guard(update_mutex);
+        map_updates.push_back(update_bin);
+        update_count.store(map_updates.size());
+      },
+      [](const cav_msgs::TrafficControlRequest&) {}, [](const cav_msgs::CheckActiveGeofence&) {},
+      std::make_unique<TestTimerFactory>());
+  wmb.setConfigSpeedLimit(CONFIG_SPEED_LIMIT_MPH);
+
+  autoware_lanelet2_msgs::MapBin map_msg;
+  lanelet::utils::conversion::toBinMsg(map, &map_msg);
+  wmb.baseMapCallback(autoware_lanelet2_msgs::MapBinConstPtr(new autoware_lanelet2_msgs::MapBin(map_msg)));
+  std_msgs::String georef;
+  georef.data = PROJ_STRING;
+  wmb.geoReferenceCallback(georef);
+
+  // the listener starts from the published base map like a node subscribed to the broadcaster
+  carma_wm::WMListenerWorker listener;
+  listener.setConfigSpeedLimit(CONFIG_SPEED_LIMIT_MPH);
+  listener.mapCallback(autoware_lanelet2_msgs::MapBinConstPtr(new autoware_lanelet2_msgs::MapBin(published_map)));
+
+  // every control message needs an associated control request id
+  cav_msgs::Route route_msg;
+  route_msg.route_path_lanelet_ids = route_ids;
+  auto req_id = std::make_shared<j2735_msgs::Id64b>();
+  wmb.controlRequestFromRoute(route_msg, req_id);
+
+  // the same seed gives every mode the same geofences
+  std::mt19937 rng(seed);
+  int active_count = 0;
+  std::vector<cav_msgs::TrafficControlMessage> msgs =
+      generateGeofences(count, lanes, segments, active_ratio, *req_id, rng, active_count);
+
+  wmb.setMapUpdateCoalescing(mode == "coalesced");
+
+  size_t applied_count = 0;
+  // collects the updates published since the last step and applies them through the listener
+  auto finishStep = [&](StepResult& step) {
+    waitForMapUpdatesToSettle(update_count);
+    if (mode == "coalesced")
+    {
+      wmb.flushMapUpdates();
+    }
+
+    std::vector<autoware_lanelet2_msgs::MapBin> step_updates;
+    {
+      std::lock_guard<std::mutex> guard(update_mutex);
+      step_updates.assign(map_updates.begin() + applied_count, map_updates.end());
+      applied_count = map_updates.size();
+    }
+
+    step.map_update_count = step_updates.size();
+    for (const auto& update : step_updates)
+    {
+      step.map_update_bytes += update.data.size();
+      step.max_map_update_bytes = std::max(step.max_map_update_bytes, update.data.size());
+    }
+
+    auto apply_start = std::chrono::steady_clock::now();
+    for (const auto& update : step_updates)
+    {
+      listener.mapUpdateCallback(autoware_lanelet2_msgs::MapBinConstPtr(new autoware_lanelet2_msgs::MapBin(update)));
+    }
+    auto apply_end = std::chrono::steady_clock::now();
+    step.listener_apply_ms = std::chrono::duration<double, std::milli>(apply_end - apply_start).count();
+  };
+
+  std::vector<StepResult> steps;
+
+  StepResult ingest_step;
+  ingest_step.sim_time = SIM_START;
+  long rss_before = residentSetKb();
+  auto ingest_start = std::chrono::steady_clock::now();
+  if (mode == "batch")
+  {
+    wmb.geofenceBatchCallback(msgs);
+  }
+  else
+  {
+    for (const auto& msg : msgs)
+    {
+      wmb.geofenceCallback(msg);
+    }
+  }
+  auto ingest_end = std::chrono::steady_clock::now();
+  ingest_step.ingest_ms = std::chrono::duration<double, std::milli>(ingest_end - ingest_start).count();
+  finishStep(ingest_step);
+  ingest_step.rss_delta_kb = residentSetKb() - rss_before;
+  steps.push_back(ingest_step);
+
+  // the last control period ends MAX_START_DELAY + MAX_CONTROL_SPAN after SIM_START at the latest
+  ros::Time schedule_end = SIM_START + ros::Duration(MAX_START_DELAY + MAX_CONTROL_SPAN);
+  for (ros::Time now = SIM_START + ros::Duration(SCHEDULE_STEP); now <= schedule_end + ros::Duration(SCHEDULE_STEP);
+       now += ros::Duration(SCHEDULE_STEP))
+  {
+    ros::Time::setNow(now);
+    StepResult step;
+    step.sim_time = now;
+    finishStep(step);
+    steps.push_back(step);
+  }
+
+  return steps;
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0]
+              << " <output_csv> [geofence_count=1000] [lanes=4] [segments=200] [active_ratio=0.5] [seed=0]" << std::endl;
+    return 1;
+  }
+
+  std::string output_csv = argv[1];
+  int geofence_count = argc > 2 ? std::atoi(argv[2]) : 1000;
+  int lanes = argc > 3 ? std::atoi(argv[3]) : 4;
+  int segments = argc > 4 ? std::atoi(argv[4]) : 200;
+  double active_ratio = argc > 5 ? std::atof(argv[5]) : 0.5;
+  unsigned seed = argc > 6 ? std::atoi(argv[6]) : 0;
+
+  if (geofence_count <= 0 || lanes <= 0 || segments <= 0)
+  {
+    std::cerr << "geofence_count, lanes and segments must be positive" << std::endl;
+    return 1;
+  }
+
+  std::ofstream out(output_csv);
+  if (!out)
+  {
+    std::cerr << "Could not open " << output_csv << std::endl;
+    return 1;
+  }
+
+  std::vector<lanelet::Id> route_ids;
+  lanelet::LaneletMapPtr map = buildGridMap(lanes, segments, route_ids);
+
+  out << "mode,geofence_count,lanes,segments,active_ratio,step,sim_time,ingest_ms,rss_delta_kb,map_update_count,"
+         "map_update_bytes,max_map_update_bytes,listener_apply_ms"
+      << std::endl;
+  for (const std::string mode : { "per_message", "batch", "coalesced" })
+  {
+    std::vector<StepResult> steps = runMode(mode, map, route_ids, geofence_count, lanes, segments, active_ratio, seed);
+
+    size_t total_updates = 0;
+    double total_apply_ms = 0;
+    for (size_t i = 0; i < steps.size(); i++)
+    {
+      const StepResult& step = steps[i];
+      out << mode << "," << geofence_count << "," << lanes << "," << segments << "," << active_ratio << "," << i << ","
+          << step.sim_time.toSec() << "," << step.ingest_ms << "," << step.rss_delta_kb << "," << step.map_update_count
+          << "," << step.map_update_bytes << "," << step.max_map_update_bytes << "," << step.listener_apply_ms
+          << std::endl;
+      total_updates += step.map_update_count;
+      total_apply_ms += step.listener_apply_ms;
+    }
+
+    std::cout << mode << ": ingested " << geofence_count << " geofences in " << steps.front().ingest_ms << " ms, "
+              << total_updates << " map updates over " << steps.size() << " steps applied by the listener in "
+              << total_apply_ms << " ms" << std::endl;
+  }
+
+  return 0;
+}
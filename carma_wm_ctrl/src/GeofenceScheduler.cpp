@@ -15,6 +15,7 @@
  */
 
 #include <carma_wm_ctrl/GeofenceScheduler.h>
+#include <algorithm>
 
 namespace carma_wm_ctrl
 {
@@ -23,7 +24,7 @@ using std::placeholders::_1;
 GeofenceScheduler::GeofenceScheduler(std::unique_ptr<TimerFactory> timerFactory)
   : timerFactory_(std::move(timerFactory))
 {
-  // Create repeating loop to clear geofence timers which are no longer needed
+  // Create repeating loop to clear transition timers which are no longer needed
   deletion_timer_ =
       timerFactory_->buildTimer(nextId(), ros::Duration(1), std::bind(&GeofenceScheduler::clearTimers, this));
 }
@@ -36,97 +37,206 @@ uint32_t GeofenceScheduler::nextId()
 
 void GeofenceScheduler::clearTimers()
 {
-  std::lock_guard<std::mutex> guard(mutex_);
-  auto it = timers_.begin();
-
-  // Erase all expired timers_ using iterators to ensure operation is safe
-  while (it != timers_.end())
+  std::vector<TimerPtr> expired_timers;
   {
-    // Check if timer is marked for deletion
-    if (it->second.second)
-    {
-      // erase() function returns the iterator of the next
-      // to last deleted element.
-      it = timers_.erase(it);
-    }
-    else
-    {
-      it++;
-    }
+    std::lock_guard<std::mutex> guard(mutex_);
+    expired_timers.swap(retired_timers_);
   }
+  // The timers are destroyed without holding the lock as a replaced timer may be waiting on it in its callback
 }
 
-void GeofenceScheduler::addGeofence(std::shared_ptr<Geofence> gf_ptr)
+bool GeofenceScheduler::addGeofence(std::shared_ptr<Geofence> gf_ptr)
 {
   std::lock_guard<std::mutex> guard(mutex_);
 
   ROS_INFO_STREAM("Attempting to add Geofence with Id: " << gf_ptr->id_);
 
-  // Create timer for next start time
+  ros::Time now = ros::Time::now();
+  bool active_now = false;
+
+  // Queue the next start time of each schedule
   for (auto schedule_idx = 0; schedule_idx < gf_ptr->schedules.size(); schedule_idx++)
   {
-    auto interval_info = gf_ptr->schedules[schedule_idx].getNextInterval(ros::Time::now());
+    auto interval_info = gf_ptr->schedules[schedule_idx].getNextInterval(now);
     ros::Time startTime = interval_info.second;
     if (!interval_info.first && startTime == ros::Time(0))
     {
       ROS_WARN_STREAM(
           "Failed to add geofence as its schedule did not contain an active or upcoming control period. GF Id: "
           << gf_ptr->id_);
-      return;
+      break;
     }
     // If this geofence is currently active set the start time to now
     if (interval_info.first)
     {
-      startTime = ros::Time::now();
+      startTime = now;
+      active_now = true;
+    }
+
+    pushTransition(startTime, Transition{ gf_ptr, static_cast<unsigned int>(schedule_idx), true });
+  }
+
+  armTimer(now);
+  return active_now;
+}
+
+void GeofenceScheduler::removeGeofence(const boost::uuids::uuid& gf_id)
+{
+  std::shared_ptr<Geofence> active_gf_ptr;
+  std::function<void(std::shared_ptr<Geofence>)> inactive_callback;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    auto gf_it = geofence_transitions_.find(gf_id);
+    if (gf_it == geofence_transitions_.end())
+    {
+      return;
     }
 
-    int32_t timer_id = nextId();
+    ROS_INFO_STREAM("Cancelling Geofence with Id: " << gf_id);
 
-    // Build timer to trigger when this geofence becomes active
-    TimerPtr timer = timerFactory_->buildTimer(
-        timer_id, startTime - ros::Time::now(),
-        std::bind(&GeofenceScheduler::startGeofenceCallback, this, _1, gf_ptr, schedule_idx, timer_id), true, true);
+    for (const auto& key : gf_it->second)
+    {
+      auto transition_it = transitions_.find(key);
+      // A pending end means one of the control periods of this geofence is in progress
+      if (!transition_it->second.is_start)
+      {
+        active_gf_ptr = transition_it->second.gf_ptr;
+      }
+      transitions_.erase(transition_it);
+    }
+    geofence_transitions_.erase(gf_it);
+    inactive_callback = inactive_callback_;
 
-    timers_[timer_id] = std::make_pair(std::move(timer), false);  // Add start timer to map by Id
+    armTimer(ros::Time::now());
+  }
+
+  if (active_gf_ptr)
+  {
+    ROS_INFO_STREAM("Deactivating Geofence with Id: " << gf_id);
+    inactive_callback(active_gf_ptr);
   }
 }
 
-void GeofenceScheduler::startGeofenceCallback(const ros::TimerEvent& event, std::shared_ptr<Geofence> gf_ptr, const unsigned int schedule_id, const int32_t timer_id)
+void GeofenceScheduler::pushTransition(const ros::Time& time, const Transition& transition)
 {
-  std::lock_guard<std::mutex> guard(mutex_);
-  ros::Time endTime = ros::Time::now() + gf_ptr->schedules[schedule_id].control_span_;
+  TransitionKey key(time, nextId());
+  transitions_.emplace(key, transition);
+  geofence_transitions_[transition.gf_ptr->id_].push_back(key);
+}
+
+void GeofenceScheduler::armTimer(const ros::Time& now)
+{
+  if (processing_transitions_)
+  {
+    return;  // The timer is armed once the transitions being triggered are done
+  }
 
-  ROS_INFO_STREAM("Activating Geofence with Id: " << gf_ptr->id_);
+  if (transitions_.empty())
+  {
+    if (transition_timer_)
+    {
+      retired_timers_.push_back(std::move(transition_timer_));
+    }
+    return;
+  }
 
-  active_callback_(gf_ptr);
+  ros::Time next_time = transitions_.begin()->first.first;
+  if (transition_timer_ && next_time == transition_timer_time_)
+  {
+    return;  // Already waiting for this transition
+  }
 
-  // Build timer to trigger when this geofence becomes inactive
-  int32_t ending_timer_id = nextId();
-  TimerPtr timer = timerFactory_->buildTimer(
-      ending_timer_id, endTime - ros::Time::now(),
-      std::bind(&GeofenceScheduler::endGeofenceCallback, this, _1, gf_ptr, schedule_id, ending_timer_id), true, true);
-  timers_[ending_timer_id] = std::make_pair(std::move(timer), false);  // Add end timer to map by Id
+  // Replace the timer. The old one cannot be destroyed here as this may be its own callback
+  if (transition_timer_)
+  {
+    retired_timers_.push_back(std::move(transition_timer_));
+  }
 
-  timers_[timer_id].second = true;  // Mark start timer for deletion
+  transition_timer_id_ = nextId();
+  transition_timer_time_ = next_time;
+  ros::Duration delay = next_time > now ? next_time - now : ros::Duration(0);
+  transition_timer_ = timerFactory_->buildTimer(
+      transition_timer_id_, delay,
+      std::bind(&GeofenceScheduler::transitionCallback, this, _1, transition_timer_id_), true, true);
 }
 
-void GeofenceScheduler::endGeofenceCallback(const ros::TimerEvent& event, std::shared_ptr<Geofence> gf_ptr, const unsigned int schedule_id, const int32_t timer_id)
+void GeofenceScheduler::transitionCallback(const ros::TimerEvent& event, const uint32_t timer_id)
 {
-  std::lock_guard<std::mutex> guard(mutex_);
+  std::vector<Transition> due_transitions;
+  std::function<void(std::shared_ptr<Geofence>)> active_callback;
+  std::function<void(std::shared_ptr<Geofence>)> inactive_callback;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    if (timer_id != transition_timer_id_)
+    {
+      return;  // This timer was replaced while it was waiting on the lock
+    }
+    transition_timer_time_ = ros::Time(0);
+    processing_transitions_ = true;
+    ros::Time now = ros::Time::now();
+
+    // Take every transition which is due first so transitions queued for now wait for the next timer
+    while (!transitions_.empty() && transitions_.begin()->first.first <= now)
+    {
+      auto transition_it = transitions_.begin();
+      auto& gf_keys = geofence_transitions_[transition_it->second.gf_ptr->id_];
+      gf_keys.erase(std::find(gf_keys.begin(), gf_keys.end(), transition_it->first));
+      if (gf_keys.empty())
+      {
+        geofence_transitions_.erase(transition_it->second.gf_ptr->id_);
+      }
+      due_transitions.push_back(transition_it->second);
+      transitions_.erase(transition_it);
+    }
+
+    for (const auto& transition : due_transitions)
+    {
+      queueNextTransition(transition, now);
+    }
+    active_callback = active_callback_;
+    inactive_callback = inactive_callback_;
+  }
 
-  ROS_INFO_STREAM("Deactivating Geofence with Id: " << gf_ptr->id_);
+  // The user callbacks are called without holding the lock so they are free to add geofences
+  for (const auto& transition : due_transitions)
+  {
+    if (transition.is_start)
+    {
+      ROS_INFO_STREAM("Activating Geofence with Id: " << transition.gf_ptr->id_);
+      active_callback(transition.gf_ptr);
+    }
+    else
+    {
+      ROS_INFO_STREAM("Deactivating Geofence with Id: " << transition.gf_ptr->id_);
+      inactive_callback(transition.gf_ptr);
+    }
+  }
 
-  inactive_callback_(gf_ptr);
-  timers_[timer_id].second = true;  // Mark timer for deletion
+  std::lock_guard<std::mutex> guard(mutex_);
+  processing_transitions_ = false;
+  armTimer(ros::Time::now());
+}
+
+void GeofenceScheduler::queueNextTransition(const Transition& transition, const ros::Time& now)
+{
+  if (transition.is_start)
+  {
+    // Queue the end of this control period
+    ros::Time endTime = now + transition.gf_ptr->schedules[transition.schedule_id].control_span_;
+    pushTransition(endTime, Transition{ transition.gf_ptr, transition.schedule_id, false });
+    return;
+  }
 
-  // Determine if a new timer is needed for this geofence
-  auto interval_info = gf_ptr->schedules[schedule_id].getNextInterval(ros::Time::now());
+  // Determine if a new start is needed for this geofence
+  auto interval_info = transition.gf_ptr->schedules[transition.schedule_id].getNextInterval(now);
   ros::Time startTime = interval_info.second;
 
   // If this geofence should currently be active set the start time to now
   if (interval_info.first)
   {
-    startTime = ros::Time::now();
+    startTime = now;
   }
 
   if (!interval_info.first && startTime == ros::Time(0))
@@ -135,14 +245,7 @@ void GeofenceScheduler::endGeofenceCallback(const ros::TimerEvent& event, std::s
     return;
   }
 
-  // Build timer to trigger when this geofence becomes active
-  int32_t start_timer_id = nextId();
-
-  TimerPtr timer = timerFactory_->buildTimer(
-      start_timer_id, startTime - ros::Time::now(),
-      std::bind(&GeofenceScheduler::startGeofenceCallback, this, _1, gf_ptr, schedule_id, start_timer_id), true, true);
-
-  timers_[start_timer_id] = std::make_pair(std::move(timer), false);  // Add start timer to map by Id
+  pushTransition(startTime, Transition{ transition.gf_ptr, transition.schedule_id, true });
 }
 
 void GeofenceScheduler::onGeofenceActive(std::function<void(std::shared_ptr<Geofence>)> active_callback)
@@ -28,6 +28,7 @@
 #include <type_traits>
 #include <cav_msgs/CheckActiveGeofence.h>
 #include <lanelet2_core/primitives/Polygon.h>
+#include <lanelet2_core/geometry/Polygon.h>
 #include <proj.h>
 #include <lanelet2_io/Projection.h>
 #include <lanelet2_core/utility/Units.h>
@@ -37,6 +38,8 @@
 #include <limits>
 #include <carma_wm/Geometry.h>
 #include <math.h>
+#include <future>
+#include <thread>
 
 namespace carma_wm_ctrl
 {
@@ -80,6 +83,21 @@ void WMBroadcaster::baseMapCallback(const autoware_lanelet2_msgs::MapBinConstPtr
   lanelet::MapConformer::ensureCompliance(base_map_, config_limit);     // Update map to ensure it complies with expectations
   lanelet::MapConformer::ensureCompliance(current_map_, config_limit);
 
+  // the tables are replaced rather than rebuilt in place as geofence batches may still be matching against the previous ones
+  auto match_tables = std::make_shared<GeofenceMatchTables>();
+  match_tables->map = current_map_;
+  buildSuccessorTable(*match_tables);
+  buildLaneletMatchGeometry(*match_tables);
+  match_tables_ = match_tables;
+
+  // map update versions count from the base map
+  published_changes_.clear();
+  published_change_index_.clear();
+  map_update_version_ = 0;
+  map_update_log_.clear();
+  snapshot_msg_valid_ = false;
+  pending_batch_ids_.clear();
+
   // Publish map
   autoware_lanelet2_msgs::MapBin compliant_map_msg;
   lanelet::utils::conversion::toBinMsg(base_map_, &compliant_map_msg);
@@ -87,13 +105,20 @@ void WMBroadcaster::baseMapCallback(const autoware_lanelet2_msgs::MapBinConstPtr
 };
 
 std::shared_ptr<Geofence> WMBroadcaster::geofenceFromMsg(const cav_msgs::TrafficControlMessageV01& msg_v01)
+{
+  // Get affected lanelet or areas by converting the georeference and querying the map using points in the geofence
+  return geofenceFromMsg(msg_v01, getAffectedLaneletOrAreas(msg_v01), current_map_);
+}
+
+// helper function that builds the geofence object once its affected lanelet or areas in map are known
+std::shared_ptr<Geofence> WMBroadcaster::geofenceFromMsg(const cav_msgs::TrafficControlMessageV01& msg_v01, const lanelet::ConstLaneletOrAreas& affected_parts,
+                                                         const lanelet::LaneletMapPtr& map) const
 {
   auto gf_ptr = std::make_shared<Geofence>(Geofence());
   // Get ID
   std::copy(msg_v01.id.id.begin(), msg_v01.id.id.end(), gf_ptr->id_.begin());
 
-  // Get affected lanelet or areas by converting the georeference and querying the map using points in the geofence
-  gf_ptr->affected_parts_ = getAffectedLaneletOrAreas(msg_v01);
+  gf_ptr->affected_parts_ = affected_parts;
 
   std::vector<lanelet::Lanelet> affected_llts;
   std::vector<lanelet::Area> affected_areas;
@@ -101,8 +126,8 @@ std::shared_ptr<Geofence> WMBroadcaster::geofenceFromMsg(const cav_msgs::Traffic
   // used for assigning them to the regem as parameters
   for (auto llt_or_area : gf_ptr->affected_parts_)
   {
-    if (llt_or_area.isLanelet()) affected_llts.push_back(current_map_->laneletLayer.get(llt_or_area.lanelet()->id()));
-    if (llt_or_area.isArea()) affected_areas.push_back(current_map_->areaLayer.get(llt_or_area.area()->id()));
+    if (llt_or_area.isLanelet()) affected_llts.push_back(map->laneletLayer.get(llt_or_area.lanelet()->id()));
+    if (llt_or_area.isArea()) affected_areas.push_back(map->areaLayer.get(llt_or_area.area()->id()));
   }
 
   // TODO: logic to determine what type of geofence goes here
@@ -259,19 +284,28 @@ void WMBroadcaster::addPassingControlLineFromMsg(std::shared_ptr<Geofence> gf_pt
   gf_ptr->regulatory_element_ = std::make_shared<lanelet::PassingControlLine>(lanelet::PassingControlLine::buildData(
     lanelet::utils::getId(), pcl_bounds, left_participants, right_participants));
 }
-// currently only supports geofence message version 1: TrafficControlMessageV01 
-void WMBroadcaster::geofenceCallback(const cav_msgs::TrafficControlMessage& geofence_msg)
+// helper function that returns the id of a geofence message as a string
+std::string WMBroadcaster::geofenceMsgId(const cav_msgs::TrafficControlMessageV01& msg_v01) const
+{
+  boost::uuids::uuid id;
+  std::copy(msg_v01.id.id.begin(), msg_v01.id.id.end(), id.begin());
+  return boost::uuids::to_string(id);
+}
+
+std::string WMBroadcaster::geofenceMsgId(const cav_msgs::TrafficControlMessage& geofence_msg) const
+{
+  return geofenceMsgId(geofence_msg.tcmV01);
+}
+
+// helper function that checks whether a geofence message should be processed
+bool WMBroadcaster::acceptGeofenceMsg(const cav_msgs::TrafficControlMessage& geofence_msg)
 {
-  
-  std::lock_guard<std::mutex> guard(map_mutex_);
   // quickly check if the id has been added
   if (geofence_msg.choice != cav_msgs::TrafficControlMessage::TCMV01)
-    return;
+    return false;
 
-  boost::uuids::uuid id;
-  std::copy(geofence_msg.tcmV01.id.id.begin(), geofence_msg.tcmV01.id.id.end(), id.begin());
-  if (checked_geofence_ids_.find(boost::uuids::to_string(id)) != checked_geofence_ids_.end())
-    return;
+  if (checked_geofence_ids_.find(geofenceMsgId(geofence_msg)) != checked_geofence_ids_.end())
+    return false;
 
   // convert reqid to string check if it has been seen before
   boost::array<uint8_t, 16UL> req_id;
@@ -283,10 +317,20 @@ void WMBroadcaster::geofenceCallback(const cav_msgs::TrafficControlMessage& geof
   if (generated_geofence_reqids_.find(reqid) == generated_geofence_reqids_.end())
   {
     ROS_WARN_STREAM("CARMA_WM_CTRL received a TrafficControlMessage with unknown TrafficControlRequest ID (reqid): " << reqid);
-    return;
+    return false;
   }
-    
-  checked_geofence_ids_.insert(boost::uuids::to_string(id));
+  return true;
+}
+
+// currently only supports geofence message version 1: TrafficControlMessageV01 
+void WMBroadcaster::geofenceCallback(const cav_msgs::TrafficControlMessage& geofence_msg)
+{
+  
+  std::lock_guard<std::mutex> guard(map_mutex_);
+  if (!acceptGeofenceMsg(geofence_msg))
+    return;
+
+  checked_geofence_ids_.insert(geofenceMsgId(geofence_msg));
   auto gf_ptr = geofenceFromMsg(geofence_msg.tcmV01);
   if (gf_ptr->affected_parts_.size() == 0)
   {
@@ -298,12 +342,123 @@ void WMBroadcaster::geofenceCallback(const cav_msgs::TrafficControlMessage& geof
 
 };
 
+// currently only supports geofence message version 1: TrafficControlMessageV01 
+void WMBroadcaster::geofenceBatchCallback(const std::vector<cav_msgs::TrafficControlMessage>& geofence_msgs)
+{
+  std::vector<const cav_msgs::TrafficControlMessageV01*> accepted_msgs;
+  std::vector<std::vector<lanelet::Point3d>> accepted_pts;
+  std::shared_ptr<const GeofenceMatchTables> match_tables;
+  {
+    // Filter the batch and convert the geofence points into the map frame. The cached PROJ transformations are not thread safe
+    std::lock_guard<std::mutex> guard(map_mutex_);
+    match_tables = match_tables_;
+    std::unordered_set<std::string> batch_ids;
+    for (const auto& geofence_msg : geofence_msgs)
+    {
+      if (!acceptGeofenceMsg(geofence_msg) || !batch_ids.insert(geofenceMsgId(geofence_msg)).second)
+        continue;
+      try
+      {
+        accepted_pts.push_back(geofencePointsInMap(geofence_msg.tcmV01));
+        accepted_msgs.push_back(&geofence_msg.tcmV01);
+      }
+      catch (const std::exception& e)
+      {
+        ROS_ERROR_STREAM("Failed to convert the points of geofence " << geofenceMsgId(geofence_msg) << ": " << e.what());
+      }
+    }
+  }
+
+  if (accepted_msgs.empty())
+    return;
+
+  // Match and convert the geofences in parallel without the lock. The workers only read the tables of the base map held above,
+  // which a new base map replaces rather than modifies, and the map geometry and lanelet layer which geofences never modify
+  std::vector<std::shared_ptr<Geofence>> geofences(accepted_msgs.size());
+  size_t worker_count = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), accepted_msgs.size());
+  std::vector<std::future<void>> workers;
+  for (size_t worker_idx = 0; worker_idx < worker_count; worker_idx++)
+  {
+    workers.push_back(std::async(std::launch::async, [&, worker_idx]() {
+      for (size_t i = worker_idx; i < accepted_msgs.size(); i += worker_count)
+      {
+        // a geofence which fails to convert is left null and not marked as checked so it is processed again if resent
+        try
+        {
+          geofences[i] = geofenceFromMsg(*accepted_msgs[i], matchAffectedLaneletOrAreas(*match_tables, accepted_pts[i]), match_tables->map);
+        }
+        catch (const std::exception& e)
+        {
+          ROS_ERROR_STREAM("Failed to convert geofence " << geofenceMsgId(*accepted_msgs[i]) << ": " << e.what());
+        }
+      }
+    }));
+  }
+  for (auto& worker : workers)
+  {
+    worker.get();
+  }
+
+  // Schedule the whole batch at once. Geofences which are active now are held back to be published as one update
+  // The scheduler triggers the activations only once this lock is released so the held ids are complete by then
+  std::lock_guard<std::mutex> guard(map_mutex_);
+  if (match_tables != match_tables_)
+  {
+    // the geofences refer to lanelets of the previous base map. They are not marked as checked so they are processed again if resent
+    ROS_WARN_STREAM("Dropping batch of " << geofences.size() << " geofences as the base map changed while it was being converted");
+    return;
+  }
+  size_t scheduled_count = 0;
+  for (auto gf_ptr : geofences)
+  {
+    if (!gf_ptr)
+      continue;
+    std::string gf_id = boost::uuids::to_string(gf_ptr->id_);
+    if (checked_geofence_ids_.find(gf_id) != checked_geofence_ids_.end())
+      continue; // scheduled by another callback while this batch was being converted
+    if (gf_ptr->affected_parts_.size() == 0)
+    {
+      ROS_WARN_STREAM("There is no applicable component in map for the new geofence message received by WMBroadcaster with id: " << gf_ptr->id_);
+      continue;
+    }
+    if (scheduler_.addGeofence(gf_ptr))  // Add the geofence to the scheduler
+    {
+      pending_batch_ids_.insert(gf_id);
+    }
+    checked_geofence_ids_.insert(gf_id);
+    scheduled_count++;
+    ROS_INFO_STREAM("New geofence message received by WMBroadcaster with id: " << gf_ptr->id_);
+  }
+  ROS_INFO_STREAM("Scheduled batch of " << scheduled_count << " geofences out of " << geofence_msgs.size() << " received");
+}
+
 void WMBroadcaster::geoReferenceCallback(const std_msgs::String& geo_ref)
 {
   std::lock_guard<std::mutex> guard(map_mutex_);
+  if (base_map_georef_ != geo_ref.data)
+  {
+    geofence_projections_.clear();
+    local_projector_.reset();
+  }
   base_map_georef_ = geo_ref.data;
 }
 
+// helper function that returns the cached transformation from the geofence proj to the map georeference, creating it on first use
+PJ* WMBroadcaster::getGeofenceProjection(const std::string& geofence_proj)
+{
+  auto it = geofence_projections_.find(geofence_proj);
+  if (it != geofence_projections_.end())
+    return it->second.get();
+
+  PJ* geofence_in_map_proj = proj_create_crs_to_crs(PJ_DEFAULT_CTX, geofence_proj.c_str(), base_map_georef_.c_str(), nullptr);
+  if (geofence_in_map_proj == nullptr)
+    throw lanelet::InvalidObjectStateError(std::string("WMBroadcaster failed to create the transformation from geofence proj: ") + geofence_proj + 
+                                          std::string(" to the map georeference: ") + base_map_georef_);
+
+  geofence_projections_.emplace(geofence_proj, std::shared_ptr<PJ>(geofence_in_map_proj, proj_destroy));
+  return geofence_in_map_proj;
+}
+
 void WMBroadcaster::setMaxLaneWidth(double max_lane_width)
 {
   max_lane_width_ = max_lane_width;
@@ -317,6 +472,13 @@ void WMBroadcaster::setConfigSpeedLimit(double cL)
 
 // currently only supports geofence message version 1: TrafficControlMessageV01 
 lanelet::ConstLaneletOrAreas WMBroadcaster::getAffectedLaneletOrAreas(const cav_msgs::TrafficControlMessageV01& tcmV01)
+{
+  std::vector<lanelet::Point3d> gf_pts = geofencePointsInMap(tcmV01);
+  return matchAffectedLaneletOrAreas(*match_tables_, gf_pts);
+}
+
+// helper function that converts the geofence points into the map frame
+std::vector<lanelet::Point3d> WMBroadcaster::geofencePointsInMap(const cav_msgs::TrafficControlMessageV01& tcmV01)
 {
   if (!current_map_)
   {
@@ -326,106 +488,185 @@ lanelet::ConstLaneletOrAreas WMBroadcaster::getAffectedLaneletOrAreas(const cav_
     throw lanelet::InvalidObjectStateError(std::string("Base lanelet map has empty proj string loaded as georeference. Therefore, WMBroadcaster failed to\n ") +
                                           std::string("get transformation between the geofence and the map"));
 
-  PJ* geofence_in_map_proj = proj_create_crs_to_crs(PJ_DEFAULT_CTX, tcmV01.geometry.proj.c_str(), base_map_georef_.c_str(), nullptr);
+  PJ* geofence_in_map_proj = getGeofenceProjection(tcmV01.geometry.proj);
   
-  // convert all geofence points into our map's frame
-  std::vector<lanelet::Point3d> gf_pts;
+  // convert all geofence points into our map's frame in one call
+  std::vector<PJ_COORD> coords;
+  coords.reserve(tcmV01.geometry.nodes.size());
   for (auto pt : tcmV01.geometry.nodes)
   {
-    PJ_COORD c {{pt.x, pt.y, 0, 0}}; // z is not currently used
-    PJ_COORD c_out;
-    c_out = proj_trans(geofence_in_map_proj, PJ_FWD, c);
+    coords.push_back(PJ_COORD {{pt.x, pt.y, 0, 0}}); // z is not currently used
+  }
+  proj_trans_array(geofence_in_map_proj, PJ_FWD, coords.size(), coords.data());
+
+  std::vector<lanelet::Point3d> gf_pts;
+  gf_pts.reserve(coords.size());
+  for (auto c_out : coords)
+  {
     gf_pts.push_back(lanelet::Point3d{current_map_->pointLayer.uniqueId(), c_out.xyz.x, c_out.xyz.y});
   }
+  return gf_pts;
+}
 
-  // Logic to detect which part is affected
+// helper function that finds the lanelets of tables.map housing the geofence points which are in the same direction as the geofence
+lanelet::ConstLaneletOrAreas WMBroadcaster::matchAffectedLaneletOrAreas(const GeofenceMatchTables& tables, const std::vector<lanelet::Point3d>& gf_pts) const
+{
+  lanelet::ConstLaneletOrAreas affected_parts;
+  if (gf_pts.empty())
+    return affected_parts;
 
-  std::unordered_set<lanelet::Lanelet> affected_lanelets;
-  for (int idx = 0; idx < gf_pts.size(); idx ++)
+  std::vector<lanelet::BasicPoint2d> pts;
+  pts.reserve(gf_pts.size());
+  for (const auto& gf_pt : gf_pts)
   {
-    std::unordered_set<lanelet::Lanelet> possible_lanelets;
-    // get nearest few nearest llts within max_lane_width_
-    // which actually house this geofence_point
-    auto searchFunc = [&](const lanelet::BoundingBox2d& lltBox, const lanelet::Lanelet& llt) 
+    pts.push_back(gf_pt.basicPoint2d());
+  }
+
+  // One range query per geofence segment returns the lanelets which can house its end points. Each segment's box is
+  // inflated by max_lane_width_ so a lane is found even if the geofence runs along it close to its bounds.
+  // housing[idx] holds the indices into candidates of the lanelets which house gf_pts[idx]
+  std::vector<const LaneletMatchGeometry*> candidates;
+  std::unordered_map<lanelet::Id, size_t> candidate_index;
+  std::vector<std::vector<size_t>> housing(pts.size());
+  const lanelet::BasicPoint2d inflation(max_lane_width_, max_lane_width_);
+  for (size_t seg = 0; seg < pts.size(); seg++)
+  {
+    size_t seg_end = std::min(seg + 1, pts.size() - 1);
+    lanelet::BoundingBox2d segment_box(pts[seg], pts[seg]);
+    segment_box.extend(pts[seg_end]);
+    segment_box.min() -= inflation;
+    segment_box.max() += inflation;
+
+    for (const auto& llt : tables.map->laneletLayer.search(segment_box))
     {
-      bool should_stop_searching = boost::geometry::distance(gf_pts[idx].basicPoint2d(), llt.polygon2d()) > max_lane_width_;
-      if (!should_stop_searching && boost::geometry::within(gf_pts[idx].basicPoint2d(), llt.polygon2d()))
+      auto geometry_it = tables.lanelet_match_geometry.find(llt.id());
+      if (geometry_it == tables.lanelet_match_geometry.end())
+        continue;
+      const LaneletMatchGeometry& geometry = geometry_it->second;
+
+      for (size_t idx : { seg, seg_end })
       {
-        possible_lanelets.insert(llt);
+        if (!geometry.box.contains(pts[idx]) || !boost::geometry::within(pts[idx], geometry.polygon))
+          continue;
+        auto inserted = candidate_index.emplace(llt.id(), candidates.size());
+        if (inserted.second)
+        {
+          candidates.push_back(&geometry);
+        }
+        size_t c = inserted.first->second;
+        if (std::find(housing[idx].begin(), housing[idx].end(), c) == housing[idx].end())
+        {
+          housing[idx].push_back(c);
+        }
       }
-      return should_stop_searching;
-    };
-
-    // this call updates possible_lanelets
-    current_map_->laneletLayer.nearestUntil(gf_pts[idx], searchFunc);
+    }
+  }
 
-    // among these llts, filter the ones that are on same direction as the geofence using routing
-    if (idx + 1 == gf_pts.size()) // we only check this for the last gf_pt after saving everything
+  std::unordered_set<lanelet::Lanelet> affected_lanelets;
+  for (size_t idx = 0; idx < pts.size(); idx++)
+  {
+    // among the llts housing the last point, filter the ones that are on same direction as the geofence using routing
+    if (idx + 1 == pts.size())
     {
-      std::unordered_set<lanelet::Lanelet> filtered = filterSuccessorLanelets(possible_lanelets, affected_lanelets);
+      std::unordered_set<lanelet::Lanelet> possible_lanelets;
+      for (size_t c : housing[idx])
+      {
+        possible_lanelets.insert(candidates[c]->llt);
+      }
+      std::unordered_set<lanelet::Lanelet> filtered = filterSuccessorLanelets(tables, possible_lanelets, affected_lanelets);
       affected_lanelets.insert(filtered.begin(), filtered.end());
       break;
-    } 
+    }
 
     // check if each lines connecting end points of the llt is crossing with the line connecting current and next gf_pts
-    for (auto llt: possible_lanelets)
+    lanelet::BasicLineString2d gf_dir_line({pts[idx], pts[idx + 1]});
+    Eigen::Vector2d start_to_end = pts[idx + 1] - pts[idx];
+    for (size_t c : housing[idx])
     {
-      lanelet::BasicLineString2d gf_dir_line({gf_pts[idx].basicPoint2d(), gf_pts[idx+1].basicPoint2d()});
-      lanelet::BasicLineString2d llt_boundary({(llt.leftBound2d().end() -1)->basicPoint2d(), (llt.rightBound2d().end() - 1)->basicPoint2d()});
-      
+      const LaneletMatchGeometry& geometry = *candidates[c];
+
       // record the llts that are on the same dir
-      if (boost::geometry::intersects(llt_boundary, gf_dir_line))
+      if (boost::geometry::intersects(geometry.end_line, gf_dir_line))
       {
-        affected_lanelets.insert(llt);
+        affected_lanelets.insert(geometry.llt);
       }
       // check condition if two geofence points are in one lanelet then check matching direction and record it also
-      else if (boost::geometry::within(gf_pts[idx+1].basicPoint2d(), llt.polygon2d()) && 
-              affected_lanelets.find(llt) == affected_lanelets.end())
-      { 
-        lanelet::BasicPoint2d median({((llt.leftBound2d().end() - 1)->basicPoint2d().x() + (llt.rightBound2d().end() - 1)->basicPoint2d().x())/2 , 
-                                      ((llt.leftBound2d().end() - 1)->basicPoint2d().y() + (llt.rightBound2d().end() - 1)->basicPoint2d().y())/2});
-        // turn into vectors
-        Eigen::Vector2d vec_to_median(median);
-        Eigen::Vector2d vec_to_gf_start(gf_pts[idx].basicPoint2d());
-        Eigen::Vector2d vec_to_gf_end(gf_pts[idx + 1].basicPoint2d());
-
-        // Get vector from start to external point
-        Eigen::Vector2d start_to_median = vec_to_median - vec_to_gf_start;
-
-        // Get vector from start to end point
-        Eigen::Vector2d start_to_end = vec_to_gf_end - vec_to_gf_start;
-
-        // Get angle between both vectors
+      else if (std::find(housing[idx + 1].begin(), housing[idx + 1].end(), c) != housing[idx + 1].end() &&
+               affected_lanelets.find(geometry.llt) == affected_lanelets.end())
+      {
+        // Get angle between the vectors from the start point to the median of the lanelet end and to the end point
+        Eigen::Vector2d start_to_median = geometry.end_median - pts[idx];
         double interior_angle = carma_wm::geometry::getAngleBetweenVectors(start_to_median, start_to_end);
         // Save the lanelet if the direction of two points inside aligns with that of the lanelet
-        if (interior_angle < M_PI_2 && interior_angle >= 0) affected_lanelets.insert(llt);
+        if (interior_angle < M_PI_2 && interior_angle >= 0) affected_lanelets.insert(geometry.llt);
       }
     }
   }
-  
+
   // Currently only returning lanelet, but this could be expanded to LanelerOrArea compound object 
   // by implementing non-const version of that LaneletOrArea
-  lanelet::ConstLaneletOrAreas affected_parts;
   affected_parts.insert(affected_parts.end(), affected_lanelets.begin(), affected_lanelets.end());
   return affected_parts;
 }
 
-// helper function that filters successor lanelets of root_lanelets from possible_lanelets
-std::unordered_set<lanelet::Lanelet> WMBroadcaster::filterSuccessorLanelets(const std::unordered_set<lanelet::Lanelet>& possible_lanelets, const std::unordered_set<lanelet::Lanelet>& root_lanelets)
+// helper function that builds the routing graph and successor table of tables.map used to filter geofence lanelets
+void WMBroadcaster::buildSuccessorTable(GeofenceMatchTables& tables) const
 {
-  std::unordered_set<lanelet::Lanelet> filtered_lanelets;
-  // we utilize routes to filter llts that are overlapping but not connected
   lanelet::traffic_rules::TrafficRulesUPtr traffic_rules_car = lanelet::traffic_rules::TrafficRulesFactory::create(
   lanelet::traffic_rules::CarmaUSTrafficRules::Location, lanelet::Participants::VehicleCar);
-  lanelet::routing::RoutingGraphUPtr map_graph = lanelet::routing::RoutingGraph::build(*current_map_, *traffic_rules_car);
-  
+  // the routing graph is only needed to find the successors so it is not kept
+  lanelet::routing::RoutingGraphUPtr routing_graph = lanelet::routing::RoutingGraph::build(*tables.map, *traffic_rules_car);
+
+  tables.successor_table.clear();
+  tables.successor_table.reserve(tables.map->laneletLayer.size());
+  for (auto llt : tables.map->laneletLayer)
+  {
+    lanelet::Ids successors;
+    for (auto following_llt : routing_graph->following(llt, false))
+    {
+      successors.push_back(following_llt.id());
+    }
+    tables.successor_table.emplace(llt.id(), std::move(successors));
+  }
+}
+
+// helper function that caches the geometry of each lanelet in tables.map which is used to match geofences
+void WMBroadcaster::buildLaneletMatchGeometry(GeofenceMatchTables& tables) const
+{
+  tables.lanelet_match_geometry.clear();
+  tables.lanelet_match_geometry.reserve(tables.map->laneletLayer.size());
+  for (auto llt : tables.map->laneletLayer)
+  {
+    LaneletMatchGeometry geometry;
+    geometry.llt = llt;
+    geometry.polygon = llt.polygon2d().basicPolygon();
+    for (const auto& pt : geometry.polygon)
+    {
+      geometry.box.extend(pt);
+    }
+    lanelet::BasicPoint2d left_end = (llt.leftBound2d().end() - 1)->basicPoint2d();
+    lanelet::BasicPoint2d right_end = (llt.rightBound2d().end() - 1)->basicPoint2d();
+    geometry.end_line = lanelet::BasicLineString2d({left_end, right_end});
+    geometry.end_median = (left_end + right_end) / 2;
+    tables.lanelet_match_geometry.emplace(llt.id(), std::move(geometry));
+  }
+}
+
+// helper function that filters successor lanelets of root_lanelets from possible_lanelets
+std::unordered_set<lanelet::Lanelet> WMBroadcaster::filterSuccessorLanelets(const GeofenceMatchTables& tables, const std::unordered_set<lanelet::Lanelet>& possible_lanelets, const std::unordered_set<lanelet::Lanelet>& root_lanelets) const
+{
+  std::unordered_set<lanelet::Lanelet> filtered_lanelets;
+  // we utilize the successor table to filter llts that are overlapping but not connected
   // as this is the last lanelet 
   // we have to filter the llts that are only geometrically overlapping yet not connected to prev llts
   for (auto recorded_llt: root_lanelets)
   {
-    for (auto following_llt: map_graph->following(recorded_llt, false))
+    auto successors = tables.successor_table.find(recorded_llt.id());
+    if (successors == tables.successor_table.end())
+      continue;
+    for (auto following_id: successors->second)
     {
-      auto mutable_llt = current_map_->laneletLayer.get(following_llt.id());
+      auto mutable_llt = tables.map->laneletLayer.get(following_id);
       auto it = possible_lanelets.find(mutable_llt);
       if (it != possible_lanelets.end())
       {
@@ -546,15 +787,21 @@ void WMBroadcaster::addGeofence(std::shared_ptr<Geofence> gf_ptr)
   // Process the geofence object to populate update remove lists
   addGeofenceHelper(gf_ptr);
   
-  for (auto pair : gf_ptr->update_list_) active_geofence_llt_ids_.insert(pair.first);
+  for (auto pair : gf_ptr->update_list_)
+  {
+    active_geofence_llt_ids_.insert(pair.first);
+    updateActiveGeofenceIndex(pair.first, true);
+  }
   
+  queueMapUpdate(gf_ptr);
+
+  // Hold back the geofences of a batch until all of its active geofences are applied
+  bool batch_member = pending_batch_ids_.erase(boost::uuids::to_string(gf_ptr->id_)) > 0;
+  if (coalesce_map_updates_ || (batch_member && !pending_batch_ids_.empty()))
+    return;
 
   // Publish
-  autoware_lanelet2_msgs::MapBin gf_msg;
-  auto send_data = std::make_shared<carma_wm::TrafficControl>(carma_wm::TrafficControl(gf_ptr->id_, gf_ptr->update_list_, gf_ptr->remove_list_));
-  carma_wm::toBinMsg(send_data, &gf_msg);
-  map_update_pub_(gf_msg);
-  
+  publishPendingMapUpdate();
 
 };
 
@@ -566,17 +813,176 @@ void WMBroadcaster::removeGeofence(std::shared_ptr<Geofence> gf_ptr)
   // Process the geofence object to populate update remove lists
   removeGeofenceHelper(gf_ptr);
 
-  for (auto pair : gf_ptr->remove_list_) active_geofence_llt_ids_.erase(pair.first);
+  for (auto pair : gf_ptr->remove_list_)
+  {
+    active_geofence_llt_ids_.erase(pair.first);
+    updateActiveGeofenceIndex(pair.first, false);
+  }
 
-  // publish
-  autoware_lanelet2_msgs::MapBin gf_msg_revert;
-  auto send_data = std::make_shared<carma_wm::TrafficControl>(carma_wm::TrafficControl(gf_ptr->id_, gf_ptr->update_list_, gf_ptr->remove_list_));
-  
-  carma_wm::toBinMsg(send_data, &gf_msg_revert);
-  map_update_pub_(gf_msg_revert);
+  queueMapUpdate(gf_ptr);
+  if (coalesce_map_updates_)
+    return;
 
+  // publish
+  publishPendingMapUpdate();
 
 };
+
+void WMBroadcaster::setMapUpdateCoalescing(bool coalesce)
+{
+  std::lock_guard<std::mutex> guard(map_mutex_);
+  coalesce_map_updates_ = coalesce;
+  if (!coalesce_map_updates_)
+    publishPendingMapUpdate();
+}
+
+void WMBroadcaster::flushMapUpdates()
+{
+  std::lock_guard<std::mutex> guard(map_mutex_);
+  // a flush publishes everything held so far, including the applied part of a batch
+  pending_batch_ids_.clear();
+  publishPendingMapUpdate();
+}
+
+// helper function that adds the changes a geofence made to the map to the pending map update
+void WMBroadcaster::queueMapUpdate(std::shared_ptr<Geofence> gf_ptr)
+{
+  // listeners apply the removals of an update before its additions, so queue them in the same order
+  for (const auto& pair : gf_ptr->remove_list_) recordMapChange(pending_changes_, pending_change_index_, pair, true);
+  for (const auto& pair : gf_ptr->update_list_) recordMapChange(pending_changes_, pending_change_index_, pair, false);
+  pending_geofence_ids_.push_back(gf_ptr->id_);
+}
+
+// helper function that records the latest change to a lanelet and regulatory element pair
+void WMBroadcaster::recordMapChange(std::vector<PendingMapChange>& changes, MapChangeIndex& change_index,
+                                    const std::pair<lanelet::Id, lanelet::RegulatoryElementPtr>& change, bool remove)
+{
+  auto key = std::make_pair(change.first, change.second->id());
+  auto it = change_index.find(key);
+  if (it == change_index.end())
+  {
+    change_index.emplace(key, changes.size());
+    changes.push_back(PendingMapChange{change, remove, remove});
+    return;
+  }
+  changes[it->second].change = change;
+  changes[it->second].remove = remove;
+}
+
+// helper function that adds the recorded changes which did not cancel out to an update
+void WMBroadcaster::addNetMapChanges(const std::vector<PendingMapChange>& changes, carma_wm::TrafficControl& update)
+{
+  for (const auto& pending : changes)
+  {
+    // a pair which ended as it started was restored, so the listeners have nothing to change
+    if (pending.first_remove != pending.remove) continue;
+    if (pending.remove)
+      update.remove_list_.push_back(pending.change);
+    else
+      update.update_list_.push_back(pending.change);
+  }
+}
+
+// helper function that publishes all pending map changes as one update
+void WMBroadcaster::publishPendingMapUpdate()
+{
+  if (pending_geofence_ids_.empty())
+    return;
+
+  // an update which only holds one geofence keeps its id
+  carma_wm::TrafficControl update;
+  update.id_ = pending_geofence_ids_.size() == 1 ? pending_geofence_ids_.front() : boost::uuids::random_generator()();
+  addNetMapChanges(pending_changes_, update);
+  update.map_version_ = ++map_update_version_;
+  if (pending_geofence_ids_.size() > 1)
+    ROS_INFO_STREAM("Publishing map update with id: " << update.id_ << " for " << pending_geofence_ids_.size() << " geofence changes");
+
+  pending_changes_.clear();
+  pending_change_index_.clear();
+  pending_geofence_ids_.clear();
+
+  // fold the update into the changes since the base map
+  for (const auto& pair : update.remove_list_) recordMapChange(published_changes_, published_change_index_, pair, true);
+  for (const auto& pair : update.update_list_) recordMapChange(published_changes_, published_change_index_, pair, false);
+  snapshot_msg_valid_ = false;
+
+  autoware_lanelet2_msgs::MapBin gf_msg;
+  auto send_data = std::make_shared<carma_wm::TrafficControl>(update);
+  carma_wm::toBinMsg(send_data, &gf_msg);
+
+  map_update_log_.push_back(gf_msg);
+  while (map_update_log_.size() > map_update_log_size_)
+    map_update_log_.pop_front();
+
+  map_update_pub_(gf_msg);
+}
+
+// helper function that publishes the net changes of every update since the base map as one update
+// the snapshot is only serialized again once a new update was published since it was last requested
+void WMBroadcaster::publishMapUpdateSnapshot()
+{
+  if (!map_update_snapshot_pub_)
+    return;
+
+  if (!snapshot_msg_valid_)
+  {
+    carma_wm::TrafficControl snapshot;
+    snapshot.id_ = boost::uuids::random_generator()();
+    addNetMapChanges(published_changes_, snapshot);
+    snapshot.map_version_ = map_update_version_;
+
+    auto send_data = std::make_shared<carma_wm::TrafficControl>(snapshot);
+    carma_wm::toBinMsg(send_data, &snapshot_msg_);
+    snapshot_msg_valid_ = true;
+  }
+  map_update_snapshot_pub_(snapshot_msg_);
+}
+
+void WMBroadcaster::onMapUpdateSnapshot(const PublishMapUpdateCallback& map_update_snapshot_pub)
+{
+  std::lock_guard<std::mutex> guard(map_mutex_);
+  map_update_snapshot_pub_ = map_update_snapshot_pub;
+}
+
+void WMBroadcaster::setMapUpdateLogSize(size_t log_size)
+{
+  std::lock_guard<std::mutex> guard(map_mutex_);
+  map_update_log_size_ = log_size;
+  while (map_update_log_.size() > map_update_log_size_)
+    map_update_log_.pop_front();
+}
+
+void WMBroadcaster::mapUpdateRequestCallback(const std_msgs::UInt64& since_version)
+{
+  std::lock_guard<std::mutex> guard(map_mutex_);
+  if (!base_map_)
+    return;
+
+  // a listener which has applied nothing, such as one which just received the base map, starts from the snapshot
+  if (since_version.data == 0)
+  {
+    ROS_INFO_STREAM("Publishing the map update snapshot of version " << map_update_version_);
+    publishMapUpdateSnapshot();
+    return;
+  }
+
+  if (since_version.data <= map_update_version_ && map_update_version_ - since_version.data <= map_update_log_.size())
+  {
+    size_t missed_count = map_update_version_ - since_version.data;
+    ROS_INFO_STREAM("Republishing " << missed_count << " map updates after version " << since_version.data);
+    for (size_t i = map_update_log_.size() - missed_count; i < map_update_log_.size(); i++)
+    {
+      map_update_pub_(map_update_log_[i]);
+    }
+    return;
+  }
+
+  // the listener can only recover by starting over from the base map, after which every listener requests the snapshot
+  ROS_WARN_STREAM("Map updates after version " << since_version.data << " are no longer logged. Republishing the base map");
+  autoware_lanelet2_msgs::MapBin base_map_msg;
+  lanelet::utils::conversion::toBinMsg(base_map_, &base_map_msg);
+  map_pub_(base_map_msg);
+}
   
 void  WMBroadcaster::routeCallbackMessage(const cav_msgs::Route& route_msg)
 {
@@ -589,6 +995,8 @@ void  WMBroadcaster::routeCallbackMessage(const cav_msgs::Route& route_msg)
 
 cav_msgs::TrafficControlRequest WMBroadcaster::controlRequestFromRoute(const cav_msgs::Route& route_msg, std::shared_ptr<j2735_msgs::Id64b> req_id_for_testing)
 {
+  std::lock_guard<std::mutex> guard(map_mutex_);
+
   lanelet::ConstLanelets path; 
 
   if (!current_map_) 
@@ -607,6 +1015,18 @@ cav_msgs::TrafficControlRequest WMBroadcaster::controlRequestFromRoute(const cav
 
   // update local copy
   route_path_ = path;
+  route_view_ = lanelet::utils::createConstMap(route_path_, {});
+
+  // the route downtrack of each lanelet is where it starts along the route
+  route_llt_downtracks_.clear();
+  double route_downtrack = 0;
+  for (const auto& llt : route_path_)
+  {
+    route_llt_downtracks_.emplace(llt.id(), route_downtrack);
+    route_downtrack += lanelet::geometry::length2d(llt);
+  }
+  active_geofence_downtracks_.clear();
+  for (auto id : active_geofence_llt_ids_) updateActiveGeofenceIndex(id, true);
   
   if(path.size() == 0) throw lanelet::InvalidObjectStateError(std::string("No lanelets available in path."));
 
@@ -656,13 +1076,16 @@ cav_msgs::TrafficControlRequest WMBroadcaster::controlRequestFromRoute(const cav
 
   }
 
-  lanelet::projection::LocalFrameProjector local_projector(target_frame.c_str());
+  if (!local_projector_)
+  {
+    local_projector_.reset(new lanelet::projection::LocalFrameProjector(target_frame.c_str()));
+  }
   lanelet::BasicPoint3d localPoint;
 
   localPoint.x()= minX;
   localPoint.y()= minY;
 
-  lanelet::GPSPoint gpsRoute = local_projector.reverse(localPoint); //If the appropriate library is included, the reverse() function can be used to convert from local xyz to lat/lon
+  lanelet::GPSPoint gpsRoute = local_projector_->reverse(localPoint); //If the appropriate library is included, the reverse() function can be used to convert from local xyz to lat/lon
 
   cav_msgs::TrafficControlRequest cR; /*Fill the latitude value in message cB with the value of lat */
   cav_msgs::TrafficControlBounds cB; /*Fill the longitude value in message cB with the value of lon*/
@@ -717,14 +1140,6 @@ double WMBroadcaster::distToNearestActiveGeofence(const lanelet::BasicPoint2d& c
     throw lanelet::InvalidObjectStateError(std::string("Lanelet map (current_map_) is not loaded to the WMBroadcaster"));
   }
 
-  // filter only the lanelets in the route
-  std::vector<lanelet::Id> active_geofence_on_route;
-  for (auto llt : route_path_)
-  {
-    if (active_geofence_llt_ids_.find(llt.id()) != active_geofence_llt_ids_.end()) 
-      active_geofence_on_route.push_back(llt.id());
-  }
-  
   // Get the lanelet of this point
   auto curr_lanelet = current_map_->laneletLayer.nearest(curr_pos, 1)[0]; //guaranteed to at least return 1 lanelet
 
@@ -732,26 +1147,46 @@ double WMBroadcaster::distToNearestActiveGeofence(const lanelet::BasicPoint2d& c
   if (!boost::geometry::within(curr_pos, curr_lanelet.polygon2d().basicPolygon()))
     throw std::invalid_argument("Given point is not within any lanelet");
 
-  // get route distance (downtrack + cross_track) distances to every lanelets by their ids
-  std::vector<double> route_distances;
-  // and take abs of cross_track to add them to get route distance
-  for (auto id: active_geofence_on_route)
+  return distToNextActiveGeofence(curr_lanelet, curr_pos);
+}
+
+// helper function that returns the route distance from a point on a lanelet to the start of the next active geofence lanelet on the route
+double WMBroadcaster::distToNextActiveGeofence(const lanelet::ConstLanelet& curr_llt, const lanelet::BasicPoint2d& curr_pos) const
+{
+  lanelet::ConstLanelet route_llt = curr_llt;
+  auto route_it = route_llt_downtracks_.find(route_llt.id());
+  if (route_it == route_llt_downtracks_.end())
   {
-    carma_wm::TrackPos tp = carma_wm::geometry::trackPos(current_map_->laneletLayer.get(id), curr_pos);
-    // downtrack needs to be negative for lanelet to be in front of the point, 
-    // also we don't account for the lanelet that the vehicle is on
-    if (tp.downtrack < 0 && id != curr_lanelet.id())
-    {
-      double dist = fabs(tp.downtrack) + fabs(tp.crosstrack);
-      route_distances.push_back(dist);
-    }
+    if (!route_view_ || route_view_->laneletLayer.empty())
+      return 0.0; // only geofences ahead on the vehicle's route are considered
+
+    // the vehicle is off the route so it is projected onto the nearest route lanelet as carma_wm::routeTrackPos does
+    route_llt = route_view_->laneletLayer.nearest(curr_pos, 1)[0];
+    route_it = route_llt_downtracks_.find(route_llt.id());
   }
-  std::sort(route_distances.begin(), route_distances.end());
 
-  if (route_distances.size() != 0 ) return route_distances[0];
-  else return 0.0;
+  // the first active lanelet starting after the current one. we don't account for the lanelet that the vehicle is on
+  auto next_it = active_geofence_downtracks_.upper_bound(std::make_pair(route_it->second, std::numeric_limits<lanelet::Id>::max()));
+  if (next_it == active_geofence_downtracks_.end())
+    return 0.0;
+
+  double curr_downtrack = route_it->second + carma_wm::geometry::trackPos(route_llt, curr_pos).downtrack;
+  return next_it->first - curr_downtrack;
+}
+
+// helper function that keeps the route downtrack index of active geofence lanelets in sync with active_geofence_llt_ids_
+void WMBroadcaster::updateActiveGeofenceIndex(lanelet::Id llt_id, bool active)
+{
+  auto route_it = route_llt_downtracks_.find(llt_id);
+  if (route_it == route_llt_downtracks_.end())
+    return;
 
+  if (active)
+    active_geofence_downtracks_.emplace(route_it->second, llt_id);
+  else
+    active_geofence_downtracks_.erase(std::make_pair(route_it->second, llt_id));
 }
+
 // helper function that detects the type of geofence and delegates
 void WMBroadcaster::addGeofenceHelper(std::shared_ptr<Geofence> gf_ptr) const
 {
@@ -785,6 +1220,7 @@ void WMBroadcaster::currentLocationCallback(const geometry_msgs::PoseStamped& cu
 
 cav_msgs::CheckActiveGeofence WMBroadcaster::checkActiveGeofenceLogic(const geometry_msgs::PoseStamped& current_pos)
 {
+  std::lock_guard<std::mutex> guard(map_mutex_);
 
   if (!current_map_ || current_map_->laneletLayer.size() == 0) 
   {
@@ -806,9 +1242,6 @@ lanelet::BasicPoint2d curr_pos;
   cav_msgs::CheckActiveGeofence outgoing_geof; //message to publish
   double next_distance = 0 ; //Distance to next geofence
 
-  
-  std::vector<double> route_distances;
-
   if (active_geofence_llt_ids_.size() <= 0 ) 
   {
     ROS_INFO_STREAM("No active geofence llt ids are loaded to the WMBroadcaster");
@@ -821,31 +1254,25 @@ lanelet::BasicPoint2d curr_pos;
     /* determine whether or not the vehicle's current position is within an active geofence */
      if (boost::geometry::within(curr_pos, current_llt.polygon2d().basicPolygon()))
       {         
-        next_distance = distToNearestActiveGeofence(curr_pos);
-        for(auto id : active_geofence_llt_ids_) 
+        next_distance = distToNextActiveGeofence(current_llt, curr_pos);
+        if (active_geofence_llt_ids_.find(current_llt.id()) != active_geofence_llt_ids_.end())
         {
-          if (id == current_llt.id())
+          outgoing_geof.type = 1;
+          outgoing_geof.is_on_active_geofence = true;
+          for (auto regem: current_llt.regulatoryElements())
           {
-            outgoing_geof.type = 1;
-            outgoing_geof.is_on_active_geofence = true;
-            for (auto regem: current_llt.regulatoryElements())
-              {
-                  if (regem->attribute(lanelet::AttributeName::Subtype).value().compare(lanelet::DigitalSpeedLimit::RuleName) == 0)
-                  {
-                    lanelet::DigitalSpeedLimitPtr speed =  std::dynamic_pointer_cast<lanelet::DigitalSpeedLimit>
-                    (current_map_->regulatoryElementLayer.get(regem->id()));
-                   outgoing_geof.value = speed->speed_limit_.value();
-                 }
-              }
-
-
+            if (regem->attribute(lanelet::AttributeName::Subtype).value().compare(lanelet::DigitalSpeedLimit::RuleName) == 0)
+            {
+              lanelet::DigitalSpeedLimitPtr speed =  std::dynamic_pointer_cast<lanelet::DigitalSpeedLimit>
+              (current_map_->regulatoryElementLayer.get(regem->id()));
+              outgoing_geof.value = speed->speed_limit_.value();
+            }
           }
         }
       }
 
       outgoing_geof.distance_to_next_geofence = next_distance;
 
-  //end for loop
     return outgoing_geof;
   
 
@@ -14,6 +14,7 @@
  * the License.
  */
 
+#include <algorithm>
 #include <carma_wm_ctrl/WMBroadcaster.h>
 #include <carma_utils/timers/ROSTimerFactory.h>
 #include <carma_wm_ctrl/WMBroadcasterNode.h>
@@ -34,6 +35,11 @@ void WMBroadcasterNode::publishMapUpdate(const autoware_lanelet2_msgs::MapBin& g
   map_update_pub_.publish(geofence_msg);
 }
 
+void WMBroadcasterNode::publishMapUpdateSnapshot(const autoware_lanelet2_msgs::MapBin& snapshot_msg) const
+{
+  map_update_snapshot_pub_.publish(snapshot_msg);
+}
+
   
 void WMBroadcasterNode::publishCtrlReq(const cav_msgs::TrafficControlRequest& ctrlreq_msg) const
 {
@@ -45,6 +51,26 @@ void WMBroadcasterNode::publishActiveGeofence(const cav_msgs::CheckActiveGeofenc
   active_pub_.publish(active_geof_msg);
 }
 
+void WMBroadcasterNode::bufferGeofence(const cav_msgs::TrafficControlMessage& geofence_msg)
+{
+  geofence_batch_.push_back(geofence_msg);
+}
+
+void WMBroadcasterNode::flushMapUpdates(const ros::TimerEvent& event)
+{
+  wmb_.flushMapUpdates();
+}
+
+void WMBroadcasterNode::flushGeofenceBatch(const ros::TimerEvent& event)
+{
+  if (geofence_batch_.empty())
+    return;
+
+  std::vector<cav_msgs::TrafficControlMessage> batch;
+  batch.swap(geofence_batch_);
+  wmb_.geofenceBatchCallback(batch);
+}
+
 
 WMBroadcasterNode::WMBroadcasterNode()
   : wmb_(std::bind(&WMBroadcasterNode::publishMap, this, _1), std::bind(&WMBroadcasterNode::publishMapUpdate, this, _1), 
@@ -55,8 +81,16 @@ int WMBroadcasterNode::run()
 {
   // Map Publisher
   map_pub_ = cnh_.advertise<autoware_lanelet2_msgs::MapBin>("semantic_map", 1, true);
-  // Map Update Publisher
-  map_update_pub_ = cnh_.advertise<autoware_lanelet2_msgs::MapBin>("map_update", 1, true);
+  // Map Update Publisher. Missed updates are republished as a burst so the queue must hold more than one
+  map_update_pub_ = cnh_.advertise<autoware_lanelet2_msgs::MapBin>("map_update", 100, true);
+  // Map Update Snapshot Publisher. Only published on request so it is not latched, as a latched snapshot goes stale
+  map_update_snapshot_pub_ = cnh_.advertise<autoware_lanelet2_msgs::MapBin>("map_update_snapshot", 10);
+  wmb_.onMapUpdateSnapshot(std::bind(&WMBroadcasterNode::publishMapUpdateSnapshot, this, _1));
+  int map_update_log_size = 100;
+  pnh_.getParam("map_update_log_size", map_update_log_size);
+  wmb_.setMapUpdateLogSize(std::max(map_update_log_size, 0));
+  // Map Update Request Sub for listeners which missed map updates
+  map_update_request_sub_ = cnh_.subscribe("map_update_request", 10, &WMBroadcaster::mapUpdateRequestCallback, &wmb_);
   //Route Message Publisher
   control_msg_pub_= cnh_.advertise<cav_msgs::TrafficControlRequest>("outgoing_geofence_request", 1, true);
   //Check Active Geofence Publisher
@@ -66,14 +100,34 @@ int WMBroadcasterNode::run()
   // Base Map Georeference Sub
   georef_sub_ = cnh_.subscribe("georeference", 1, &WMBroadcaster::geoReferenceCallback, &wmb_);
   // Geofence Sub
-  geofence_sub_ = cnh_.subscribe("geofence", 1, &WMBroadcaster::geofenceCallback, &wmb_);
+  double geofence_batch_window = 0.0;
+  pnh_.getParam("geofence_batch_window", geofence_batch_window);
+  if (geofence_batch_window > 0.0)
+  {
+    // Collect the geofences received within each window and ingest them as one batch
+    geofence_sub_ = cnh_.subscribe("geofence", 1000, &WMBroadcasterNode::bufferGeofence, this);
+    geofence_batch_timer_ = cnh_.createTimer(ros::Duration(geofence_batch_window), &WMBroadcasterNode::flushGeofenceBatch, this);
+  }
+  else
+  {
+    geofence_sub_ = cnh_.subscribe("geofence", 1, &WMBroadcaster::geofenceCallback, &wmb_);
+  }
   //Route Message Sub
   route_callmsg_sub_ = cnh_.subscribe("route", 1, &WMBroadcaster::routeCallbackMessage, &wmb_);
   //Current Location Sub
   curr_location_sub_ = cnh_.subscribe("current_pose", 1,&WMBroadcaster::currentLocationCallback, &wmb_);
   
+  // Map updates are either published as each geofence changes or coalesced over a window
+  double map_update_coalesce_window = 0.0;
+  pnh_.getParam("map_update_coalesce_window", map_update_coalesce_window);
+  if (map_update_coalesce_window > 0.0)
+  {
+    wmb_.setMapUpdateCoalescing(true);
+    map_update_timer_ = cnh_.createTimer(ros::Duration(map_update_coalesce_window), &WMBroadcasterNode::flushMapUpdates, this);
+  }
+
   double config_limit;
-  double lane_max_width;
+  double lane_max_width = 4.0;
   pnh_.getParam("max_lane_width", lane_max_width);
   wmb_.setMaxLaneWidth(lane_max_width);
 
@@ -90,7 +90,7 @@ TEST(GeofenceScheduler, addGeofence)
   ASSERT_EQ(0, last_active_gf.load());
   ASSERT_EQ(0, last_inactive_gf.load());
 
-  scheduler.addGeofence(gf_ptr);
+  ASSERT_FALSE(scheduler.addGeofence(gf_ptr));  // not active yet
 
   ros::Time::setNow(ros::Time(1.0));  // Set current time
 
@@ -142,7 +142,7 @@ TEST(GeofenceScheduler, addGeofence)
   // Basic check that expired geofence is not added
   boost::uuids::uuid second_id = boost::uuids::random_generator()();
   gf_ptr->id_ = second_id;
-  scheduler.addGeofence(gf_ptr);
+  ASSERT_FALSE(scheduler.addGeofence(gf_ptr));
 
   ros::Time::setNow(ros::Time(11.0));  // Set current time
 
@@ -153,4 +153,121 @@ TEST(GeofenceScheduler, addGeofence)
   ASSERT_EQ(first_id_hashed, last_inactive_gf.load());
 }
 
+TEST(GeofenceScheduler, coTimedGeofences)
+{
+  // Many geofences with the same schedule should all be triggered together and cancelled geofences should stop
+  ros::Time::setNow(ros::Time(0));  // Set current time
+
+  GeofenceScheduler scheduler(std::make_unique<TestTimerFactory>());  // Create scheduler
+  std::atomic<uint32_t> active_call_count(0);
+  std::atomic<uint32_t> inactive_call_count(0);
+  scheduler.onGeofenceActive([&](std::shared_ptr<Geofence> gf_ptr) {
+    active_call_count.store(active_call_count.load() + 1);
+  });
+  scheduler.onGeofenceInactive([&](std::shared_ptr<Geofence> gf_ptr) {
+    inactive_call_count.store(inactive_call_count.load() + 1);
+  });
+
+  const uint32_t geofence_count = 100;
+  std::vector<std::shared_ptr<Geofence>> geofences;
+  for (uint32_t i = 0; i < geofence_count; i++)
+  {
+    auto gf_ptr = std::make_shared<Geofence>(Geofence());
+    gf_ptr->id_ = boost::uuids::random_generator()();
+    gf_ptr->schedules.push_back(
+        GeofenceSchedule(ros::Time(1),  // Schedule between 1 and 8
+                         ros::Time(8),
+                         ros::Duration(2),    // Starts at 2
+                         ros::Duration(3.5),  // Ends at by 5.5
+                         ros::Duration(0),    // repetition start 0 offset, so still start at 2
+                         ros::Duration(1),    // Duration of 1 and interval of 2 so active durations are (2-3 and 4-5)
+                         ros::Duration(2)));
+    geofences.push_back(gf_ptr);
+    scheduler.addGeofence(gf_ptr);
+  }
+
+  // Cancelling a geofence before it starts drops it without a callback
+  scheduler.removeGeofence(geofences[0]->id_);
+
+  ros::Time::setNow(ros::Time(2.1));  // Set current time
+
+  ASSERT_TRUE(carma_utils::testing::waitForEqOrTimeout(10.0, geofence_count - 1, active_call_count));
+  ASSERT_EQ(0, inactive_call_count.load());
+
+  // Cancelling an active geofence deactivates it right away
+  scheduler.removeGeofence(geofences[1]->id_);
+  ASSERT_EQ(1, inactive_call_count.load());
+
+  // Cancelling a geofence twice has no effect
+  scheduler.removeGeofence(geofences[1]->id_);
+  ASSERT_EQ(1, inactive_call_count.load());
+
+  ros::Time::setNow(ros::Time(3.1));  // Set current time
+
+  ASSERT_TRUE(carma_utils::testing::waitForEqOrTimeout(10.0, geofence_count - 1, inactive_call_count));
+  ASSERT_EQ(geofence_count - 1, active_call_count.load());
+
+  ros::Time::setNow(ros::Time(4.2));  // Set current time
+
+  ASSERT_TRUE(carma_utils::testing::waitForEqOrTimeout(10.0, 2 * (geofence_count - 2) + 1, active_call_count));
+  ASSERT_EQ(geofence_count - 1, inactive_call_count.load());
+}
+
+TEST(GeofenceScheduler, removeGeofence)
+{
+  // A geofence cancelled before it starts should never be activated or deactivated
+  ros::Time::setNow(ros::Time(0));  // Set current time
+
+  GeofenceScheduler scheduler(std::make_unique<TestTimerFactory>());  // Create scheduler
+
+  auto cancelled_gf = std::make_shared<Geofence>(Geofence());
+  cancelled_gf->id_ = boost::uuids::random_generator()();
+  auto kept_gf = std::make_shared<Geofence>(Geofence());
+  kept_gf->id_ = boost::uuids::random_generator()();
+  for (auto gf_ptr : { cancelled_gf, kept_gf })
+  {
+    gf_ptr->schedules.push_back(
+        GeofenceSchedule(ros::Time(1),  // Schedule between 1 and 8
+                         ros::Time(8),
+                         ros::Duration(2),    // Starts at 2
+                         ros::Duration(3.5),  // Ends at by 5.5
+                         ros::Duration(0),    // repetition start 0 offset, so still start at 2
+                         ros::Duration(1),    // Duration of 1 and interval of 2 so active durations are (2-3 and 4-5)
+                         ros::Duration(2)));
+  }
+
+  std::atomic<uint32_t> cancelled_active_count(0);
+  std::atomic<uint32_t> cancelled_inactive_count(0);
+  std::atomic<uint32_t> kept_active_count(0);
+  std::atomic<uint32_t> kept_inactive_count(0);
+  scheduler.onGeofenceActive([&](std::shared_ptr<Geofence> gf_ptr) {
+    auto& count = gf_ptr->id_ == cancelled_gf->id_ ? cancelled_active_count : kept_active_count;
+    count.store(count.load() + 1);
+  });
+  scheduler.onGeofenceInactive([&](std::shared_ptr<Geofence> gf_ptr) {
+    auto& count = gf_ptr->id_ == cancelled_gf->id_ ? cancelled_inactive_count : kept_inactive_count;
+    count.store(count.load() + 1);
+  });
+
+  ASSERT_FALSE(scheduler.addGeofence(cancelled_gf));
+  ASSERT_FALSE(scheduler.addGeofence(kept_gf));
+  scheduler.removeGeofence(cancelled_gf->id_);
+
+  // Run through both control periods. The kept geofence shows the transitions were triggered
+  ros::Time::setNow(ros::Time(2.1));  // Set current time
+  ASSERT_TRUE(carma_utils::testing::waitForEqOrTimeout(10.0, 1, kept_active_count));
+
+  ros::Time::setNow(ros::Time(3.1));  // Set current time
+  ASSERT_TRUE(carma_utils::testing::waitForEqOrTimeout(10.0, 1, kept_inactive_count));
+
+  ros::Time::setNow(ros::Time(4.2));  // Set current time
+  ASSERT_TRUE(carma_utils::testing::waitForEqOrTimeout(10.0, 2, kept_active_count));
+
+  ros::Time::setNow(ros::Time(5.5));  // Set current time
+  ASSERT_TRUE(carma_utils::testing::waitForEqOrTimeout(10.0, 2, kept_inactive_count));
+
+  ASSERT_EQ(0, cancelled_active_count.load());
+  ASSERT_EQ(0, cancelled_inactive_count.load());
+}
+
 }  // namespace carma_wm_ctrl
\ No newline at end of file
@@ -29,6 +29,7 @@
 #include <chrono>
 #include <ctime>
 #include <atomic>
+#include <thread>
 #include <carma_utils/testing/TestHelpers.h>
 #include <carma_utils/timers/testing/TestTimer.h>
 #include <carma_utils/timers/testing/TestTimerFactory.h>
@@ -260,6 +261,66 @@ TEST(WMBroadcaster, getAffectedLaneletOrAreasOnlyLogic)
   ASSERT_EQ(affected_parts.size(), 2); // they should not be considered to be on the lanelet
 }
 
+TEST(WMBroadcaster, getAffectedLaneletOrAreasLongGeofence)
+{
+  using namespace lanelet::units::literals;
+  WMBroadcaster wmb(
+      [](const autoware_lanelet2_msgs::MapBin& map_bin) {}, [](const autoware_lanelet2_msgs::MapBin& map_bin) {},
+      [](const cav_msgs::TrafficControlRequest& control_msg_pub_){}, [](const cav_msgs::CheckActiveGeofence& active_pub_){},
+      std::make_unique<TestTimerFactory>());
+
+  // Two parallel lanes of 50 connected lanelets each
+  const int segments = 50;
+  std::vector<lanelet::Lanelet> llts;
+  std::vector<lanelet::Point3d> prev_pts = { carma_wm::getPoint(0, 0, 0), carma_wm::getPoint(1, 0, 0), carma_wm::getPoint(2, 0, 0) };
+  for (int s = 0; s < segments; s++)
+  {
+    std::vector<lanelet::Point3d> next_pts = { carma_wm::getPoint(0, s + 1, 0), carma_wm::getPoint(1, s + 1, 0), carma_wm::getPoint(2, s + 1, 0) };
+    llts.push_back(carma_wm::getLanelet(20000 + s, { prev_pts[0], next_pts[0] }, { prev_pts[1], next_pts[1] }));
+    llts.push_back(carma_wm::getLanelet(30000 + s, { prev_pts[1], next_pts[1] }, { prev_pts[2], next_pts[2] }));
+    prev_pts = next_pts;
+  }
+  lanelet::LaneletMapPtr map = lanelet::utils::createMap(llts, {});
+
+  autoware_lanelet2_msgs::MapBin msg;
+  lanelet::utils::conversion::toBinMsg(map, &msg);
+  wmb.baseMapCallback(autoware_lanelet2_msgs::MapBinConstPtr(new autoware_lanelet2_msgs::MapBin(msg)));
+
+  std_msgs::String sample_proj_string;
+  std::string proj_string = "+proj=tmerc +lat_0=39.46636844371259 +lon_0=-76.16919523566943 +k=1 +x_0=0 +y_0=0 +datum=WGS84 +units=m +vunits=m +no_defs";
+  sample_proj_string.data = proj_string;
+  wmb.geoReferenceCallback(sample_proj_string);
+
+  // one point in the middle of every lanelet of the left lane
+  cav_msgs::TrafficControlMessageV01 gf_msg;
+  gf_msg.geometry.proj = proj_string;
+  cav_msgs::PathNode pt;
+  for (int s = 0; s < segments; s++)
+  {
+    pt.x = 0.5; pt.y = s + 0.5; pt.z = 0;
+    gf_msg.geometry.nodes.push_back(pt);
+  }
+
+  lanelet::ConstLaneletOrAreas affected_parts = wmb.getAffectedLaneletOrAreas(gf_msg);
+  ASSERT_EQ(segments, affected_parts.size());
+  for (const auto& part : affected_parts)
+  {
+    ASSERT_GE(part.id(), 20000);
+    ASSERT_LT(part.id(), 20000 + segments);
+  }
+
+  // the lane width only bounds the search around each geofence segment, lanelets still have to house the points
+  wmb.setMaxLaneWidth(0.1);
+  ASSERT_EQ(segments, wmb.getAffectedLaneletOrAreas(gf_msg).size());
+  wmb.setMaxLaneWidth(10.0);
+  ASSERT_EQ(segments, wmb.getAffectedLaneletOrAreas(gf_msg).size());
+
+  // reversing the geofence leaves no lanelet in its direction
+  std::reverse(gf_msg.geometry.nodes.begin(), gf_msg.geometry.nodes.end());
+  affected_parts = wmb.getAffectedLaneletOrAreas(gf_msg);
+  ASSERT_EQ(0, affected_parts.size());
+}
+
 TEST(WMBroadcaster, geofenceCallback)
 {
   // Test adding then evaluate if the calls to active and inactive are done correctly
@@ -414,6 +475,119 @@ TEST(WMBroadcaster, geofenceCallback)
 
 }
   
+TEST(WMBroadcaster, geofenceBatchCallback)
+{
+  // variables needed to test
+  std::atomic<uint32_t> map_update_call_count(0);
+  std::shared_ptr<carma_wm::TrafficControl> last_update;
+
+  WMBroadcaster wmb(
+      [](const autoware_lanelet2_msgs::MapBin& map_bin) {},
+      [&](const autoware_lanelet2_msgs::MapBin& geofence_bin) {
+        auto data_received = std::make_shared<carma_wm::TrafficControl>(carma_wm::TrafficControl());
+        carma_wm::fromBinMsg(geofence_bin, data_received);
+        last_update = data_received;
+        map_update_call_count.store(map_update_call_count.load() + 1);
+      }, [](const cav_msgs::TrafficControlRequest& control_msg_pub_){},
+      [](const cav_msgs::CheckActiveGeofence& active_pub_){},
+      std::make_unique<TestTimerFactory>());
+
+  // Get and convert map to binary message
+  auto map = carma_wm::getBroadcasterTestMap();
+  autoware_lanelet2_msgs::MapBin msg;
+  lanelet::utils::conversion::toBinMsg(map, &msg);
+  autoware_lanelet2_msgs::MapBinConstPtr map_msg_ptr(new autoware_lanelet2_msgs::MapBin(msg));
+  wmb.baseMapCallback(map_msg_ptr);
+
+  std_msgs::String sample_proj_string;
+  std::string proj_string = "+proj=tmerc +lat_0=39.46636844371259 +lon_0=-76.16919523566943 +k=1 +x_0=0 +y_0=0 +datum=WGS84 +units=m +vunits=m +no_defs";
+  sample_proj_string.data = proj_string;
+  wmb.geoReferenceCallback(sample_proj_string);
+
+  // every control message needs associated control request id
+  cav_msgs::Route route_msg;
+  route_msg.route_path_lanelet_ids.push_back(10000);
+  std::shared_ptr<j2735_msgs::Id64b> req_id = std::make_shared<j2735_msgs::Id64b>(j2735_msgs::Id64b());
+  wmb.controlRequestFromRoute(route_msg, req_id);
+
+  // speed limit geofence across the two lanelets of the map, active between 2 and 3
+  cav_msgs::TrafficControlMessageV01 msg_v01;
+  msg_v01.reqid = *req_id;
+  msg_v01.geometry.proj = proj_string;
+  cav_msgs::PathNode pt;
+  pt.x = 0.5; pt.y = 0.5; pt.z = 0;
+  msg_v01.geometry.nodes.push_back(pt);
+  pt.x = 0.5; pt.y = 1.5; pt.z = 0;
+  msg_v01.geometry.nodes.push_back(pt);
+  msg_v01.params.detail.choice = cav_msgs::TrafficControlDetail::MAXSPEED_CHOICE;
+  msg_v01.params.detail.maxspeed = 10;
+  msg_v01.params.schedule.start = ros::Time(1);
+  msg_v01.params.schedule.end = ros::Time(8);
+  cav_msgs::DailySchedule daily_schedule;
+  daily_schedule.begin = ros::Duration(2);
+  daily_schedule.duration = ros::Duration(1.1);
+  msg_v01.params.schedule.between.push_back(daily_schedule);
+  msg_v01.params.schedule.repeat.offset = ros::Duration(0);
+  msg_v01.params.schedule.repeat.span = ros::Duration(1);
+  msg_v01.params.schedule.repeat.period = ros::Duration(2);
+
+  std::vector<cav_msgs::TrafficControlMessage> batch;
+  cav_msgs::TrafficControlMessage gf_msg;
+  gf_msg.choice = cav_msgs::TrafficControlMessage::TCMV01;
+
+  // two different geofences
+  std::vector<boost::uuids::uuid> gf_ids;
+  for (int i = 0; i < 2; i++)
+  {
+    gf_ids.push_back(boost::uuids::random_generator()());
+    std::copy(gf_ids.back().begin(), gf_ids.back().end(), msg_v01.id.id.begin());
+    gf_msg.tcmV01 = msg_v01;
+    batch.push_back(gf_msg);
+  }
+  // duplicate of the first geofence
+  batch.push_back(batch.front());
+  // geofence whose points cannot be converted into the map frame
+  cav_msgs::TrafficControlMessage malformed = gf_msg;
+  boost::uuids::uuid malformed_id = boost::uuids::random_generator()();
+  std::copy(malformed_id.begin(), malformed_id.end(), malformed.tcmV01.id.id.begin());
+  malformed.tcmV01.geometry.proj = "invalid";
+  batch.push_back(malformed);
+  // geofence answering an unknown request
+  boost::uuids::uuid unknown_id = boost::uuids::random_generator()();
+  std::copy(unknown_id.begin(), unknown_id.end(), msg_v01.id.id.begin());
+  msg_v01.reqid.id[0] = msg_v01.reqid.id[0] + 1;
+  gf_msg.tcmV01 = msg_v01;
+  batch.push_back(gf_msg);
+  // unsupported message version
+  gf_msg.choice = cav_msgs::TrafficControlMessage::RESERVED;
+  batch.push_back(gf_msg);
+
+  ros::Time::setNow(ros::Time(2.1));  // Both geofences are active
+  wmb.geofenceBatchCallback(batch);
+
+  // The activation of both geofences is published as one update
+  ASSERT_TRUE(carma_utils::testing::waitForEqOrTimeout(10.0, (uint32_t)1, map_update_call_count));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_EQ(1, map_update_call_count.load());
+  ASSERT_NE(last_update->id_, gf_ids[0]);
+  ASSERT_NE(last_update->id_, gf_ids[1]);
+
+  std::unordered_set<lanelet::Id> regem_ids;
+  for (auto pair : last_update->update_list_) regem_ids.insert(pair.second->id());
+  ASSERT_EQ(2, regem_ids.size());
+
+  // Geofences already seen are ignored
+  wmb.geofenceBatchCallback(batch);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_EQ(1, map_update_call_count.load());
+
+  // A geofence which failed to convert was not marked as checked so it is scheduled once resent correctly
+  malformed.tcmV01.geometry.proj = proj_string;
+  wmb.geofenceBatchCallback({ malformed });
+  ASSERT_TRUE(carma_utils::testing::waitForEqOrTimeout(10.0, (uint32_t)2, map_update_call_count));
+  ASSERT_EQ(last_update->id_, malformed_id);
+}
+
 TEST(WMBroadcaster, routeCallbackMessage) 
 {
   cav_msgs::Route route_msg;
@@ -579,6 +753,208 @@ TEST(WMBroadcaster, addAndRemoveGeofence)
 
 }
 
+TEST(WMBroadcaster, coalesceMapUpdates)
+{
+  using namespace lanelet::units::literals;
+  size_t map_update_call_count = 0;
+  std::shared_ptr<carma_wm::TrafficControl> last_update;
+  WMBroadcaster wmb(
+      [](const autoware_lanelet2_msgs::MapBin& map_bin) {},
+      [&](const autoware_lanelet2_msgs::MapBin& geofence_bin) {
+        last_update = std::make_shared<carma_wm::TrafficControl>(carma_wm::TrafficControl());
+        carma_wm::fromBinMsg(geofence_bin, last_update);
+        map_update_call_count++;
+      }, [](const cav_msgs::TrafficControlRequest& control_msg_pub_){},
+      [](const cav_msgs::CheckActiveGeofence& active_pub_){},
+      std::make_unique<TestTimerFactory>());
+
+  auto map = carma_wm::getBroadcasterTestMap();
+  lanelet::DigitalSpeedLimitPtr old_speed_limit = std::make_shared<lanelet::DigitalSpeedLimit>(lanelet::DigitalSpeedLimit::buildData(lanelet::InvalId, 5_mph, {}, {},
+                                                     { lanelet::Participants::VehicleCar }));
+  map->update(map->laneletLayer.get(10000), old_speed_limit);
+  autoware_lanelet2_msgs::MapBin msg;
+  lanelet::utils::conversion::toBinMsg(map, &msg);
+  autoware_lanelet2_msgs::MapBinConstPtr map_msg_ptr(new autoware_lanelet2_msgs::MapBin(msg));
+  wmb.baseMapCallback(map_msg_ptr);
+  std_msgs::String sample_proj_string;
+  std::string proj_string = "+proj=tmerc +lat_0=39.46636844371259 +lon_0=-76.16919523566943 +k=1 +x_0=0 +y_0=0 +datum=WGS84 +units=m +vunits=m +no_defs";
+  sample_proj_string.data = proj_string;
+  wmb.geoReferenceCallback(sample_proj_string);
+
+  // Two speed limit geofences over the same lanelets
+  cav_msgs::TrafficControlMessageV01 gf_msg;
+  gf_msg.geometry.proj = proj_string;
+  cav_msgs::PathNode pt;
+  pt.x = 0.5; pt.y = 0.5; pt.z = 0;
+  gf_msg.geometry.nodes.push_back(pt);
+  pt.x = 0.5; pt.y = 1.5; pt.z = 0;
+  gf_msg.geometry.nodes.push_back(pt);
+  std::vector<std::shared_ptr<carma_wm_ctrl::Geofence>> geofences;
+  for (int i = 0; i < 2; i++)
+  {
+    auto gf_ptr = std::make_shared<carma_wm_ctrl::Geofence>(carma_wm_ctrl::Geofence());
+    gf_ptr->id_ = boost::uuids::random_generator()();
+    gf_ptr->regulatory_element_ = std::make_shared<lanelet::DigitalSpeedLimit>(lanelet::DigitalSpeedLimit::buildData(lanelet::utils::getId(), 10_mph, {}, {},
+                                                     { lanelet::Participants::VehicleCar }));
+    gf_ptr->affected_parts_ = wmb.getAffectedLaneletOrAreas(gf_msg);
+    ASSERT_EQ(gf_ptr->affected_parts_.size(), 2);
+    geofences.push_back(gf_ptr);
+  }
+
+  wmb.setMapUpdateCoalescing(true);
+
+  // Nothing is published until the updates are flushed
+  wmb.flushMapUpdates();
+  ASSERT_EQ(map_update_call_count, 0);
+  wmb.addGeofence(geofences[0]);
+  wmb.addGeofence(geofences[1]);
+  ASSERT_EQ(map_update_call_count, 0);
+
+  wmb.flushMapUpdates();
+  ASSERT_EQ(map_update_call_count, 1);
+  ASSERT_NE(last_update->id_, geofences[0]->id_);
+  ASSERT_NE(last_update->id_, geofences[1]->id_);
+  // The second geofence replaced the speed limit of the first one, so only the original speed limits
+  // are removed and only the speed limit of the second geofence is added
+  ASSERT_EQ(last_update->remove_list_.size(), 2);
+  ASSERT_EQ(last_update->remove_list_[1].second->id(), old_speed_limit->id());
+  ASSERT_EQ(last_update->update_list_.size(), 2);
+  for (auto pair : last_update->update_list_) ASSERT_EQ(pair.second->id(), geofences[1]->regulatory_element_->id());
+
+  // A geofence which is deactivated and activated again within one update has no net change
+  wmb.removeGeofence(geofences[1]);
+  wmb.addGeofence(geofences[1]);
+  ASSERT_EQ(map_update_call_count, 1);
+  wmb.flushMapUpdates();
+  ASSERT_EQ(map_update_call_count, 2);
+  ASSERT_EQ(last_update->remove_list_.size(), 0);
+  ASSERT_EQ(last_update->update_list_.size(), 0);
+
+  // A single geofence keeps its id
+  wmb.removeGeofence(geofences[0]);
+  wmb.flushMapUpdates();
+  ASSERT_EQ(map_update_call_count, 3);
+  ASSERT_EQ(last_update->id_, geofences[0]->id_);
+
+  // Disabling coalescing publishes the held changes and then publishes each change
+  wmb.removeGeofence(geofences[1]);
+  wmb.setMapUpdateCoalescing(false);
+  ASSERT_EQ(map_update_call_count, 4);
+  ASSERT_EQ(last_update->id_, geofences[1]->id_);
+  wmb.addGeofence(geofences[1]);
+  ASSERT_EQ(map_update_call_count, 5);
+}
+
+TEST(WMBroadcaster, mapUpdateVersionsAndSnapshot)
+{
+  using namespace lanelet::units::literals;
+  size_t base_map_call_count = 0;
+  std::vector<std::shared_ptr<carma_wm::TrafficControl>> updates;
+  std::vector<std::shared_ptr<carma_wm::TrafficControl>> snapshots;
+  WMBroadcaster wmb(
+      [&](const autoware_lanelet2_msgs::MapBin& map_bin) { base_map_call_count++; },
+      [&](const autoware_lanelet2_msgs::MapBin& geofence_bin) {
+        updates.push_back(std::make_shared<carma_wm::TrafficControl>(carma_wm::TrafficControl()));
+        carma_wm::fromBinMsg(geofence_bin, updates.back());
+      }, [](const cav_msgs::TrafficControlRequest& control_msg_pub_){},
+      [](const cav_msgs::CheckActiveGeofence& active_pub_){},
+      std::make_unique<TestTimerFactory>());
+  wmb.onMapUpdateSnapshot([&](const autoware_lanelet2_msgs::MapBin& snapshot_bin) {
+    snapshots.push_back(std::make_shared<carma_wm::TrafficControl>(carma_wm::TrafficControl()));
+    carma_wm::fromBinMsg(snapshot_bin, snapshots.back());
+  });
+  wmb.setMapUpdateLogSize(2);
+
+  auto map = carma_wm::getBroadcasterTestMap();
+  autoware_lanelet2_msgs::MapBin msg;
+  lanelet::utils::conversion::toBinMsg(map, &msg);
+  autoware_lanelet2_msgs::MapBinConstPtr map_msg_ptr(new autoware_lanelet2_msgs::MapBin(msg));
+  wmb.baseMapCallback(map_msg_ptr);
+  std_msgs::String sample_proj_string;
+  std::string proj_string = "+proj=tmerc +lat_0=39.46636844371259 +lon_0=-76.16919523566943 +k=1 +x_0=0 +y_0=0 +datum=WGS84 +units=m +vunits=m +no_defs";
+  sample_proj_string.data = proj_string;
+  wmb.geoReferenceCallback(sample_proj_string);
+
+  // Snapshots are only published on request
+  ASSERT_EQ(base_map_call_count, 1);
+  ASSERT_EQ(snapshots.size(), 0);
+
+  // Two speed limit geofences over the same lanelets
+  cav_msgs::TrafficControlMessageV01 gf_msg;
+  gf_msg.geometry.proj = proj_string;
+  cav_msgs::PathNode pt;
+  pt.x = 0.5; pt.y = 0.5; pt.z = 0;
+  gf_msg.geometry.nodes.push_back(pt);
+  pt.x = 0.5; pt.y = 1.5; pt.z = 0;
+  gf_msg.geometry.nodes.push_back(pt);
+  std::vector<std::shared_ptr<carma_wm_ctrl::Geofence>> geofences;
+  for (int i = 0; i < 2; i++)
+  {
+    auto gf_ptr = std::make_shared<carma_wm_ctrl::Geofence>(carma_wm_ctrl::Geofence());
+    gf_ptr->id_ = boost::uuids::random_generator()();
+    gf_ptr->regulatory_element_ = std::make_shared<lanelet::DigitalSpeedLimit>(lanelet::DigitalSpeedLimit::buildData(lanelet::utils::getId(), 10_mph, {}, {},
+                                                     { lanelet::Participants::VehicleCar }));
+    gf_ptr->affected_parts_ = wmb.getAffectedLaneletOrAreas(gf_msg);
+    ASSERT_EQ(gf_ptr->affected_parts_.size(), 2);
+    geofences.push_back(gf_ptr);
+  }
+
+  // Each update carries the next version
+  wmb.addGeofence(geofences[0]);
+  wmb.addGeofence(geofences[1]);
+  ASSERT_EQ(updates.size(), 2);
+  for (size_t i = 0; i < updates.size(); i++) ASSERT_EQ(updates[i]->map_version_, i + 1);
+  ASSERT_EQ(snapshots.size(), 0);
+
+  // A listener without any update is sent the snapshot even though the log still reaches back to the base map
+  std_msgs::UInt64 since_version;
+  since_version.data = 0;
+  wmb.mapUpdateRequestCallback(since_version);
+  ASSERT_EQ(updates.size(), 2);
+  ASSERT_EQ(snapshots.size(), 1);
+  ASSERT_EQ(base_map_call_count, 1);
+
+  // The snapshot holds only the second speed limit as the first one was replaced
+  ASSERT_EQ(snapshots[0]->map_version_, 2);
+  ASSERT_EQ(snapshots[0]->update_list_.size(), 2);
+  for (auto pair : snapshots[0]->update_list_) ASSERT_EQ(pair.second->id(), geofences[1]->regulatory_element_->id());
+  ASSERT_EQ(snapshots[0]->remove_list_.size(), updates[0]->remove_list_.size());
+
+  // The same snapshot is sent again until another update is published
+  wmb.mapUpdateRequestCallback(since_version);
+  ASSERT_EQ(snapshots.size(), 2);
+  ASSERT_EQ(snapshots[1]->id_, snapshots[0]->id_);
+
+  wmb.removeGeofence(geofences[1]);
+  ASSERT_EQ(updates.size(), 3);
+  ASSERT_EQ(updates.back()->map_version_, 3);
+  ASSERT_EQ(snapshots.size(), 2);
+
+  // Logged updates are republished in order
+  since_version.data = 1;
+  wmb.mapUpdateRequestCallback(since_version);
+  ASSERT_EQ(updates.size(), 5);
+  ASSERT_EQ(updates[3]->map_version_, 2);
+  ASSERT_EQ(updates[4]->map_version_, 3);
+  since_version.data = 3;
+  wmb.mapUpdateRequestCallback(since_version);
+  ASSERT_EQ(updates.size(), 5);
+
+  since_version.data = 0;
+  wmb.mapUpdateRequestCallback(since_version);
+  ASSERT_EQ(snapshots.size(), 3);
+  ASSERT_EQ(snapshots.back()->map_version_, 3);
+  ASSERT_NE(snapshots.back()->id_, snapshots[0]->id_);
+
+  // A listener further behind than the log starts over from the base map
+  wmb.setMapUpdateLogSize(1);
+  since_version.data = 1;
+  wmb.mapUpdateRequestCallback(since_version);
+  ASSERT_EQ(updates.size(), 5);
+  ASSERT_EQ(base_map_call_count, 2);
+  ASSERT_EQ(snapshots.size(), 3);
+}
+
 TEST(WMBroadcaster, GeofenceBinMsgTest)
 {
   using namespace lanelet::units::literals;
@@ -1205,6 +1581,17 @@ TEST(WMBroadcaster, distToNearestActiveGeofence)
   curr_pos = {1.5,3.5};  // it is currently not on any lanelet
   EXPECT_THROW(wmb.distToNearestActiveGeofence(curr_pos), std::invalid_argument);
 
+  // a vehicle which is off the route is projected onto the nearest route lanelet
+  cav_msgs::Route detour_msg;
+  detour_msg.route_path_lanelet_ids.push_back(10000);
+  detour_msg.route_path_lanelet_ids.push_back(10002);
+  detour_msg.route_path_lanelet_ids.push_back(10003);
+  wmb.controlRequestFromRoute(detour_msg);
+  curr_pos = {1.2,0.3};  // on 10001 which is not on the route, closest to 10000
+  nearest_gf_dist = wmb.distToNearestActiveGeofence(curr_pos);
+  ASSERT_NEAR(nearest_gf_dist, 0.7, 0.0001);
+  wmb.controlRequestFromRoute(route_msg);
+
   activated = false;
   ros::Time::setNow(ros::Time(3.2));  // Geofences deactivate now
   ASSERT_TRUE(carma_utils::testing::waitForEqOrTimeout(10.0, curr_id_hashed, last_inactive_gf));
@@ -1356,6 +1743,7 @@ TEST(WMBroadcaster, currentLocationCallback)
 
   cav_msgs::CheckActiveGeofence check = wmb.checkActiveGeofenceLogic(input_msg);
   ASSERT_GE(check.distance_to_next_geofence, 0);
+  ASSERT_NEAR(check.distance_to_next_geofence, 0.5, 0.0001);  // start of the next active lanelet on the route
   EXPECT_TRUE(check.type > 0);
   EXPECT_TRUE(check.is_on_active_geofence);
 
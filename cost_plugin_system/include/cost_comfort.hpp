@@ -24,7 +24,7 @@ class CostofComfort : public CostPlugins
 public:
     CostofComfort(double max_deceleration);
 
-    double compute_cost(cav_msgs::ManeuverPlan plan) const;
+    double compute_cost(const cav_msgs::ManeuverPlan& plan) const;
 
 private:
     double max_deceleration_;
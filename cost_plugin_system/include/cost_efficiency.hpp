@@ -24,7 +24,7 @@ class CostofEfficiency : public CostPlugins
 public:
     CostofEfficiency(double speed_limit, double speed_buffer);
 
-    double compute_cost(cav_msgs::ManeuverPlan plan) const;
+    double compute_cost(const cav_msgs::ManeuverPlan& plan) const;
 private:
     double speed_limit_;
     double speed_buffer_;
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2018-2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <vector>
+#include <ros/ros.h>
+#include <cav_msgs/ManeuverPlan.h>
+#include "cost_legality.hpp"
+#include "maneuver_columns.hpp"
+
+namespace cost_plugin_system
+{
+/**
+ * \brief Parameters shared by all of the cost terms of the cost plugin system
+ */
+struct CostEvaluatorConfig
+{
+    double max_accelaration = 5.0;
+    double max_decelaration = 8.0;
+    double speed_limit = 27.0;
+    double speed_buffer = 25.0;
+    double weight_of_comfort = 1.0;
+    double weight_of_efficiency = 1.0;
+    double weight_of_feasibility = 1.0;
+    double weight_of_fuel = 1.0;
+    double weight_of_safety = 1.0;
+};
+
+/**
+ * \brief In-process evaluator for the weighted total cost of maneuver plans
+ *
+ * Plans are first extracted into ManeuverColumns and all weighted cost terms are then
+ * evaluated in a single pass over those columns. The result matches the weighted sum of
+ * CostofComfort, CostofEfficiency, CostofFeasibility, CostofFuel and CostofSafety.
+ * Used by the cost_plugin_system node to serve compute_plan_cost and may be linked
+ * directly by other nodes (such as the arbitrator) to avoid a service round trip per plan.
+ */
+class CostEvaluator
+{
+public:
+    /**
+     * \brief Constructor
+     * \param config The cost term parameters and weights to use
+     */
+    explicit CostEvaluator(const CostEvaluatorConfig& config = CostEvaluatorConfig());
+
+    /**
+     * \brief Load the cost term parameters and weights from the parameter server
+     * \param nh The nodehandle whose namespace contains the cost plugin system parameters
+     * \return The loaded config. Parameters which are not set keep their default value
+     */
+    static CostEvaluatorConfig loadConfig(const ros::NodeHandle& nh);
+
+    /**
+     * \brief Compute the weighted total cost of a maneuver plan
+     * \param plan The plan to evaluate
+     * \return The total cost, or -999.0 if the plan is not legal
+     */
+    double compute_cost(const cav_msgs::ManeuverPlan& plan) const;
+
+    /**
+     * \brief Compute the weighted total cost of each plan in a batch without copying the plans
+     * \param plans The plans to evaluate. Must not contain null pointers
+     * \return The total cost of each plan in the same order as the input
+     */
+    std::vector<double> compute_costs(const std::vector<const cav_msgs::ManeuverPlan*>& plans) const;
+
+    /**
+     * \brief Compute the weighted total cost of each plan in a batch
+     * \param plans The plans to evaluate
+     * \return The total cost of each plan in the same order as the input
+     */
+    std::vector<double> compute_costs(const std::vector<cav_msgs::ManeuverPlan>& plans) const;
+
+    /**
+     * \brief Compute the weighted total cost of each plan held in a set of columns
+     * \param columns The extracted maneuvers of the plans to evaluate
+     * \return The total cost of each plan in the same order as the columns. Legality is not evaluated
+     */
+    std::vector<double> compute_costs(const ManeuverColumns& columns) const;
+
+private:
+    /**
+     * \brief Evaluate all weighted cost terms over the maneuvers in [begin, end) of the columns
+     */
+    double compute_weighted_cost(const ManeuverColumns& columns, size_t begin, size_t end) const;
+
+    CostEvaluatorConfig config_;
+    CostofLegality legality_;
+};
+} // namespace cost_plugin_system
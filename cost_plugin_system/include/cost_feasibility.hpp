@@ -24,7 +24,7 @@ class CostofFeasibility : public CostPlugins
 public:
     CostofFeasibility(double max_accelaration, double max_deceleration);
 
-    double compute_cost(cav_msgs::ManeuverPlan plan) const;
+    double compute_cost(const cav_msgs::ManeuverPlan& plan) const;
 
 private:
     double max_accelaration_;
@@ -24,6 +24,6 @@ class CostofFuel : public CostPlugins
 public:
     CostofFuel() {};
 
-    double compute_cost(cav_msgs::ManeuverPlan plan) const;
+    double compute_cost(const cav_msgs::ManeuverPlan& plan) const;
 };
 } // namespace cost_plugin_system
\ No newline at end of file
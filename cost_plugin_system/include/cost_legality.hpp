@@ -25,6 +25,6 @@ class CostofLegality : public CostPlugins
 
     CostofLegality() {};
 
-    double compute_cost(cav_msgs::ManeuverPlan plan) const;
+    double compute_cost(const cav_msgs::ManeuverPlan& plan) const;
 };
 }
\ No newline at end of file
@@ -22,12 +22,7 @@
 #include <carma_utils/CARMAUtils.h>
 #include <cav_msgs/ManeuverPlan.h>
 #include <cav_srvs/ComputePlanCost.h>
-#include "cost_safety.hpp"
-#include "cost_fuel.hpp"
-#include "cost_legality.hpp"
-#include "cost_comfort.hpp"
-#include "cost_efficiency.hpp"
-#include "cost_feasibility.hpp"
+#include "cost_evaluator.hpp"
 
 namespace cost_plugin_system
 {
@@ -56,17 +51,14 @@ public:
     // Service servers
     ros::ServiceServer compute_plan_cost_service_server_;
 
-    double compute_final_score(cav_msgs::ManeuverPlan plan);
+    /**
+     * \brief Compute the weighted total cost of a maneuver plan
+     * \param plan The plan to evaluate
+     * \return The total cost, or -999.0 if the plan is not legal
+     */
+    double compute_final_score(const cav_msgs::ManeuverPlan& plan) const;
 private:
-    double max_accelaration_;
-    double max_decelaration_;
-    double speed_limit_;
-    double speed_buffer_;
-    double weight_of_comfort_;
-    double weight_of_efficiency_;
-    double weight_of_feasibility_;
-    double weight_of_fuel_;
-    double weight_of_safety_;
+    CostEvaluator evaluator_;
 
     bool get_score(cav_srvs::ComputePlanCostRequest& req, cav_srvs::ComputePlanCostResponse& res);
 };
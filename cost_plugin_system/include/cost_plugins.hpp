@@ -28,7 +28,7 @@ public:
      * \param plan The plan to evaluate
      * \return double The total cost
      */
-    virtual double compute_cost(cav_msgs::ManeuverPlan plan) const = 0;
+    virtual double compute_cost(const cav_msgs::ManeuverPlan& plan) const = 0;
 
     /**
      * \brief Virtual destructor provided for memory safety
@@ -24,7 +24,7 @@ class CostofSafety : public CostPlugins
 public:
     CostofSafety(double speed_limit);
 
-    double compute_cost(cav_msgs::ManeuverPlan plan) const;
+    double compute_cost(const cav_msgs::ManeuverPlan& plan) const;
 
 private:
     double speed_limit_;
@@ -14,6 +14,8 @@
  * the License.
  */
 
+#pragma once
+
 #include <string>
 #include <ros/ros.h>
 #include <cav_msgs/ManeuverPlan.h>
@@ -36,15 +38,29 @@
                         ((mvr).type == cav_msgs::Maneuver::LANE_FOLLOWING ? (mvr).lane_following_maneuver.property :\
                             throw std::invalid_argument("GET_MANEUVER_PROPERTY (property) called on maneuver with invalid type id")))))))
 
+/**
+ * \brief Table of the maneuver types supported by the cost_utils maneuver accessors
+ * 
+ * Expands X once per maneuver type as X(type_id, member, starting_lane_field, ending_lane_field, arg) where
+ * type_id is the cav_msgs::Maneuver type constant, member is the cav_msgs::Maneuver field holding that maneuver type
+ * and arg is passed through unchanged. Adding a maneuver type here adds it to every accessor.
+ */
+#define COST_UTILS_MANEUVER_TYPES(X, arg)\
+        X(INTERSECTION_TRANSIT_LEFT_TURN, intersection_transit_left_turn_maneuver, starting_lane_id, ending_lane_id, arg)\
+        X(INTERSECTION_TRANSIT_RIGHT_TURN, intersection_transit_right_turn_maneuver, starting_lane_id, ending_lane_id, arg)\
+        X(INTERSECTION_TRANSIT_STRAIGHT, intersection_transit_straight_maneuver, starting_lane_id, ending_lane_id, arg)\
+        X(LANE_CHANGE, lane_change_maneuver, starting_lane_id, ending_lane_id, arg)\
+        X(LANE_FOLLOWING, lane_following_maneuver, lane_id, lane_id, arg)
+
 namespace cost_utils
 {
     /**
      * \brief Get the start time of the first maneuver in the plan
      * \param plan The plan to examine
-     * \return The ros::Time at which it starts
+     * \return A reference to the ros::Time at which it starts
      * \throws An invalid argument exception if the plan is empty
      */
-    ros::Time get_plan_start_time(const cav_msgs::ManeuverPlan&);
+    const ros::Time& get_plan_start_time(const cav_msgs::ManeuverPlan&);
 
     /**
      * \brief Get the start distance of the first maneuver in the plan
@@ -57,10 +73,10 @@ namespace cost_utils
     /**
      * \brief Get the end time of the first maneuver in the plan
      * \param plan The plan to examine
-     * \return The ros::Time at which it ends
+     * \return A reference to the ros::Time at which it ends
      * \throws An invalid argument exception if the plan is empty
      */
-    ros::Time get_plan_end_time(const cav_msgs::ManeuverPlan&);
+    const ros::Time& get_plan_end_time(const cav_msgs::ManeuverPlan&);
 
     /**
      * \brief Get the end distance of the first maneuver in the plan
@@ -73,10 +89,10 @@ namespace cost_utils
     /**
      * \brief Get the start time of the specified maneuver
      * \param mvr The maneuver to examine
-     * \return The ros::Time at which it starts
+     * \return A reference to the ros::Time at which it starts
      * \throws An invalid argument exception if the maneuver is poorly constructed
      */
-    ros::Time get_maneuver_start_time(const cav_msgs::Maneuver&);
+    const ros::Time& get_maneuver_start_time(const cav_msgs::Maneuver&);
 
     /**
      * \brief Get the start distance the specified maneuver
@@ -89,10 +105,10 @@ namespace cost_utils
     /**
      * \brief Get the end time of the specified maneuver
      * \param mvr The maneuver to examine
-     * \return The ros::Time at which it ends
+     * \return A reference to the ros::Time at which it ends
      * \throws An invalid argument exception if the maneuver is poorly constructed
      */
-    ros::Time get_maneuver_end_time(const cav_msgs::Maneuver&);
+    const ros::Time& get_maneuver_end_time(const cav_msgs::Maneuver&);
 
     /**
      * \brief Get the end distance of the specified maneuver
@@ -121,16 +137,16 @@ namespace cost_utils
     /**
      * \brief Get the starting lane of the specified maneuver
      * \param mvr The maneuver to examine
-     * \return The string-valued starting lane id of the maneuver
+     * \return A reference to the starting lane id of the maneuver
      * \throws An invalid argument exception if the maneuver is poorly constructed
      */
-    std::string get_maneuver_starting_lane_id(const cav_msgs::Maneuver&);
+    const std::string& get_maneuver_starting_lane_id(const cav_msgs::Maneuver&);
 
     /**
      * \brief Get the ending lane of the specified maneuver
      * \param mvr The maneuver to examine
-     * \return The string-valued ending lane id of the maneuver
+     * \return A reference to the ending lane id of the maneuver
      * \throws An invalid argument exception if the maneuver is poorly constructed
      */
-    std::string get_maneuver_ending_lane_id(const cav_msgs::Maneuver&);
+    const std::string& get_maneuver_ending_lane_id(const cav_msgs::Maneuver&);
 } // namespace arbitrator
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2018-2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <cav_msgs/ManeuverPlan.h>
+
+namespace cost_plugin_system
+{
+/**
+ * \brief Columnar copy of the fields the cost terms read from the maneuvers of one or more plans
+ *
+ * Each column holds one entry per maneuver. The maneuvers of plan i occupy the
+ * index range [plan_offsets[i], plan_offsets[i + 1]).
+ */
+struct ManeuverColumns
+{
+    std::vector<double> start_time;
+    std::vector<double> end_time;
+    std::vector<double> start_speed;
+    std::vector<double> end_speed;
+    std::vector<uint8_t> lane_change; // 1 if the starting and ending lane ids differ, 0 otherwise
+
+    std::vector<size_t> plan_offsets{0};
+
+    /**
+     * \brief Remove all maneuvers and plans while keeping the allocated storage
+     */
+    void clear();
+
+    /**
+     * \brief Reserve storage for the given number of maneuvers and plans
+     */
+    void reserve(size_t maneuver_count, size_t plan_count);
+
+    /**
+     * \brief Append the maneuvers of a plan as a new plan in the columns
+     * \param plan The plan to extract
+     * \throws std::invalid_argument if a maneuver has an invalid type
+     */
+    void append(const cav_msgs::ManeuverPlan& plan);
+
+    /**
+     * \brief The number of plans held in the columns
+     */
+    size_t plan_count() const;
+};
+} // namespace cost_plugin_system
@@ -26,7 +26,7 @@ CostofComfort::CostofComfort(double max_deceleration)
     max_deceleration_ = max_deceleration;
 }
 
-double CostofComfort::compute_cost(cav_msgs::ManeuverPlan plan) const
+double CostofComfort::compute_cost(const cav_msgs::ManeuverPlan& plan) const
 {
     double cost = 0.0;
     int maneuver_size = plan.maneuvers.size();
@@ -27,7 +27,7 @@ CostofEfficiency::CostofEfficiency(double speed_limit, double speed_buffer)
     speed_buffer_ = speed_buffer;
 }
 
-double CostofEfficiency::compute_cost(cav_msgs::ManeuverPlan plan) const
+double CostofEfficiency::compute_cost(const cav_msgs::ManeuverPlan& plan) const
 {
     double cost = 0.0;
     int maneuver_size = plan.maneuvers.size();
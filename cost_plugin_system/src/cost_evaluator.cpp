@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2018-2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cmath>
+#include "cost_evaluator.hpp"
+
+namespace cost_plugin_system
+{
+
+CostEvaluator::CostEvaluator(const CostEvaluatorConfig& config)
+    : config_(config)
+{
+}
+
+CostEvaluatorConfig CostEvaluator::loadConfig(const ros::NodeHandle& nh)
+{
+    CostEvaluatorConfig config;
+
+    nh.param<double>("max_accelaration", config.max_accelaration, config.max_accelaration);
+    nh.param<double>("max_decelaration", config.max_decelaration, config.max_decelaration);
+
+    nh.param<double>("speed_limit", config.speed_limit, config.speed_limit);
+    nh.param<double>("speed_buffer", config.speed_buffer, config.speed_buffer);
+
+    nh.param<double>("weight_of_comfort", config.weight_of_comfort, config.weight_of_comfort);
+    nh.param<double>("weight_of_efficiency", config.weight_of_efficiency, config.weight_of_efficiency);
+    nh.param<double>("weight_of_feasibility", config.weight_of_feasibility, config.weight_of_feasibility);
+    nh.param<double>("weight_of_fuel", config.weight_of_fuel, config.weight_of_fuel);
+    nh.param<double>("weight_of_safety", config.weight_of_safety, config.weight_of_safety);
+
+    return config;
+}
+
+double CostEvaluator::compute_weighted_cost(const ManeuverColumns& columns, size_t begin, size_t end) const
+{
+    const double max_accelaration = config_.max_accelaration;
+    const double max_decelaration = config_.max_decelaration;
+    const double speed_limit = config_.speed_limit;
+    const double speed_buffer = config_.speed_buffer;
+    const double safety_coefficient = (1 + speed_limit * speed_limit) / (speed_limit * speed_limit);
+
+    const double* start_speed = columns.start_speed.data();
+    const double* end_speed = columns.end_speed.data();
+    const double* start_time = columns.start_time.data();
+    const double* end_time = columns.end_time.data();
+    const uint8_t* lane_change = columns.lane_change.data();
+
+    double cost_of_comfort = 0.0;
+    double cost_of_efficiency = 0.0;
+    double cost_of_feasibility = 0.0;
+    double cost_of_fuel = 0.0;
+    double cost_of_safety = 0.0;
+
+    // Single fused pass over the maneuvers. Each term accumulates exactly as the matching CostPlugins class does
+    for (size_t i = begin; i < end; i++)
+    {
+        double average_speed = (start_speed[i] + end_speed[i]) / 2;
+        double average_acceleration = (end_speed[i] - start_speed[i]) / (end_time[i] - start_time[i]);
+
+        cost_of_comfort += std::fabs(average_acceleration);
+        cost_of_comfort += lane_change[i];
+
+        cost_of_efficiency += average_speed < speed_buffer ? 1 - 1 / speed_buffer * average_speed :
+                              average_speed > speed_limit ? 1 :
+                              1 / (speed_limit - speed_buffer) * average_speed - speed_buffer / (speed_limit - speed_buffer);
+
+        cost_of_feasibility += (average_acceleration > max_accelaration || average_acceleration < max_decelaration) ? 1 : 0;
+
+        cost_of_fuel += average_speed * average_speed + average_acceleration * average_acceleration;
+
+        cost_of_safety += average_speed * average_speed - safety_coefficient * average_speed + 1;
+    }
+
+    // Normalize each term as the CostPlugins classes do. CostofFeasibility and CostofSafety normalize
+    // by sizeof(plan.maneuvers) rather than the maneuver count, which is kept here so costs are unchanged
+    const int maneuver_size = end - begin;
+    const int maneuver_container_size = sizeof(cav_msgs::ManeuverPlan::_maneuvers_type);
+    cost_of_comfort = cost_of_comfort / ((std::fabs(max_decelaration) + 1.0) * maneuver_size);
+    cost_of_efficiency = cost_of_efficiency / maneuver_size;
+    cost_of_feasibility = cost_of_feasibility / (maneuver_container_size * 2);
+    cost_of_fuel = cost_of_fuel / (1000.0 * maneuver_size);
+    cost_of_safety = cost_of_safety / (speed_limit * speed_limit * maneuver_container_size);
+
+    return config_.weight_of_comfort * cost_of_comfort + config_.weight_of_efficiency * cost_of_efficiency +
+           config_.weight_of_feasibility * cost_of_feasibility + config_.weight_of_fuel * cost_of_fuel +
+           config_.weight_of_safety * cost_of_safety;
+}
+
+double CostEvaluator::compute_cost(const cav_msgs::ManeuverPlan& plan) const
+{
+    if (legality_.compute_cost(plan) != 0)
+    {
+        return -999.0;
+    }
+
+    ManeuverColumns columns;
+    columns.reserve(plan.maneuvers.size(), 1);
+    columns.append(plan);
+    return compute_weighted_cost(columns, 0, columns.plan_offsets[1]);
+}
+
+std::vector<double> CostEvaluator::compute_costs(const ManeuverColumns& columns) const
+{
+    std::vector<double> costs;
+    costs.reserve(columns.plan_count());
+    for (size_t i = 0; i < columns.plan_count(); i++)
+    {
+        costs.push_back(compute_weighted_cost(columns, columns.plan_offsets[i], columns.plan_offsets[i + 1]));
+    }
+    return costs;
+}
+
+std::vector<double> CostEvaluator::compute_costs(const std::vector<const cav_msgs::ManeuverPlan*>& plans) const
+{
+    // Extract the whole batch into one set of columns before evaluating any of it
+    size_t maneuver_count = 0;
+    for (const cav_msgs::ManeuverPlan* plan : plans)
+    {
+        maneuver_count += plan->maneuvers.size();
+    }
+    ManeuverColumns columns;
+    columns.reserve(maneuver_count, plans.size());
+    for (const cav_msgs::ManeuverPlan* plan : plans)
+    {
+        columns.append(*plan);
+    }
+
+    std::vector<double> costs = compute_costs(columns);
+    for (size_t i = 0; i < plans.size(); i++)
+    {
+        if (legality_.compute_cost(*plans[i]) != 0)
+        {
+            costs[i] = -999.0;
+        }
+    }
+    return costs;
+}
+
+std::vector<double> CostEvaluator::compute_costs(const std::vector<cav_msgs::ManeuverPlan>& plans) const
+{
+    std::vector<const cav_msgs::ManeuverPlan*> plan_ptrs;
+    plan_ptrs.reserve(plans.size());
+    for (const cav_msgs::ManeuverPlan& plan : plans)
+    {
+        plan_ptrs.push_back(&plan);
+    }
+    return compute_costs(plan_ptrs);
+}
+} // namespace cost_plugin_system
@@ -26,7 +26,7 @@ CostofFeasibility::CostofFeasibility(double max_accelaration, double max_deceler
     max_accelaration_ = max_accelaration;
     max_deceleration_ = max_deceleration;
 }
-double CostofFeasibility::compute_cost(cav_msgs::ManeuverPlan plan) const
+double CostofFeasibility::compute_cost(const cav_msgs::ManeuverPlan& plan) const
 {
     double cost = 0.0;
     int maneuver_size = sizeof(plan.maneuvers);
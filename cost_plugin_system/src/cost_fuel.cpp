@@ -21,7 +21,7 @@
 namespace cost_plugin_system
 {
 
-double CostofFuel::compute_cost(cav_msgs::ManeuverPlan plan) const
+double CostofFuel::compute_cost(const cav_msgs::ManeuverPlan& plan) const
 {
     double cost = 0.0;
     int maneuver_size = plan.maneuvers.size();
@@ -23,7 +23,7 @@ namespace cost_plugin_system
 // TODO: There is no environment/infrastructure data to
 //       this cost_plugin_system node now, so the compute_cost is empty.
 //       This needs to be done later.
-double CostofLegality::compute_cost(cav_msgs::ManeuverPlan plan) const
+double CostofLegality::compute_cost(const cav_msgs::ManeuverPlan& plan) const
 {
 
     double cost = 0.0;
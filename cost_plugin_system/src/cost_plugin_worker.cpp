@@ -26,55 +26,19 @@ void CostPluginWorker::init()
     nh_.reset(new ros::CARMANodeHandle());
     pnh_.reset(new ros::CARMANodeHandle("~"));
 
-    pnh_->param<double>("max_accelaration", max_accelaration_, 5.0);
-    pnh_->param<double>("max_decelaration", max_decelaration_, 8.0);
-
-    pnh_->param<double>("speed_limit", speed_limit_, 27.0);
-    pnh_->param<double>("speed_buffer", speed_buffer_, 25.0);
-
-    pnh_->param<double>("weight_of_comfort", weight_of_comfort_, 1.0);
-    pnh_->param<double>("weight_of_efficiency", weight_of_efficiency_, 1.0);
-    pnh_->param<double>("weight_of_feasibility", weight_of_feasibility_, 1.0);
-    pnh_->param<double>("weight_of_fuel", weight_of_fuel_, 1.0);
-    pnh_->param<double>("weight_of_safety", weight_of_safety_, 1.0);
+    evaluator_ = CostEvaluator(CostEvaluator::loadConfig(*pnh_));
 }
 
 bool CostPluginWorker::get_score(cav_srvs::ComputePlanCostRequest& req, cav_srvs::ComputePlanCostResponse& res)
 {
-    cav_msgs::ManeuverPlan plan = req.maneuver_plan;
-
-    res.plan_cost = compute_final_score(plan);
+    res.plan_cost = compute_final_score(req.maneuver_plan);
 
     return true;
 }
 
-double CostPluginWorker::compute_final_score(cav_msgs::ManeuverPlan plan)
+double CostPluginWorker::compute_final_score(const cav_msgs::ManeuverPlan& plan) const
 {
-    cost_plugin_system::CostofComfort coc(max_decelaration_);
-    cost_plugin_system::CostofEfficiency coe(speed_limit_, speed_buffer_);
-    cost_plugin_system::CostofFeasibility cofe(max_accelaration_, max_decelaration_);
-    cost_plugin_system::CostofFuel cof;
-    cost_plugin_system::CostofLegality col;
-    cost_plugin_system::CostofSafety cos(speed_limit_);
-
-    double total_cost = 0.0;
-    if (col.compute_cost(plan) == 0)
-    {
-        double cost_of_comfort = coc.compute_cost(plan);
-        double cost_of_efficiency = coe.compute_cost(plan);
-        double cost_of_feasibility = cofe.compute_cost(plan);
-        double cost_of_fuel = cof.compute_cost(plan);
-        double cost_of_safety = cos.compute_cost(plan);
-
-        total_cost = weight_of_comfort_ * cost_of_comfort + weight_of_efficiency_ * cost_of_efficiency +
-                     weight_of_feasibility_ * cost_of_feasibility + weight_of_fuel_ * cost_of_fuel +
-                     weight_of_safety_ * cost_of_safety;
-    }
-    else
-    {
-        total_cost = -999.0;
-    }
-    return total_cost;
+    return evaluator_.compute_cost(plan);
 }
 
 void CostPluginWorker::run()
@@ -26,7 +26,7 @@ CostofSafety::CostofSafety(double speed_limit)
     speed_limit_ = speed_limit;
 }
 
-double CostofSafety::compute_cost(cav_msgs::ManeuverPlan plan) const
+double CostofSafety::compute_cost(const cav_msgs::ManeuverPlan& plan) const
 {
     double cost = 0.0;
     int maneuver_size = sizeof(plan.maneuvers);
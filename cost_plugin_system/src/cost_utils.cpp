@@ -17,19 +17,44 @@
 #include "cost_utils.hpp"
 #include <cav_msgs/Maneuver.h>
 #include <exception>
+#include <stdexcept>
+
+/**
+ * \brief Expands to a switch case returning the given field of the maneuver type described by a COST_UTILS_MANEUVER_TYPES row
+ */
+#define COST_UTILS_RETURN_FIELD_CASE(type_id, member, starting_lane_field, ending_lane_field, field)\
+        case cav_msgs::Maneuver::type_id: return mvr.member.field;
+
+#define COST_UTILS_RETURN_STARTING_LANE_CASE(type_id, member, starting_lane_field, ending_lane_field, unused)\
+        case cav_msgs::Maneuver::type_id: return mvr.member.starting_lane_field;
+
+#define COST_UTILS_RETURN_ENDING_LANE_CASE(type_id, member, starting_lane_field, ending_lane_field, unused)\
+        case cav_msgs::Maneuver::type_id: return mvr.member.ending_lane_field;
+
+/**
+ * \brief Defines an accessor which returns the given field of a maneuver by dispatching over every row of COST_UTILS_MANEUVER_TYPES
+ */
+#define COST_UTILS_DEFINE_MANEUVER_ACCESSOR(return_type, name, case_macro, field)\
+        return_type name(const cav_msgs::Maneuver &mvr)\
+        {\
+            switch (mvr.type)\
+            {\
+                COST_UTILS_MANEUVER_TYPES(case_macro, field)\
+                default: break;\
+            }\
+            throw std::invalid_argument("cost_plugin_system::" #name " called on maneuver with invalid type id");\
+        }
 
 namespace cost_utils
 {
-ros::Time get_plan_end_time(const cav_msgs::ManeuverPlan &plan)
+const ros::Time& get_plan_end_time(const cav_msgs::ManeuverPlan &plan)
 {
     if (plan.maneuvers.empty())
     {
         throw std::invalid_argument("cost_plugin_system::get_plan_end_time called on empty maneuver plan");
     }
 
-    cav_msgs::Maneuver m = plan.maneuvers.back();
-
-    return get_maneuver_end_time(m);
+    return get_maneuver_end_time(plan.maneuvers.back());
 }
 
 double get_plan_end_distance(const cav_msgs::ManeuverPlan &plan)
@@ -39,19 +64,17 @@ double get_plan_end_distance(const cav_msgs::ManeuverPlan &plan)
         throw std::invalid_argument("cost_plugin_system::get_plan_end_dist called on empty maneuver plan");
     }
 
-    cav_msgs::Maneuver m = plan.maneuvers.back();
-    return get_maneuver_end_distance(m);
+    return get_maneuver_end_distance(plan.maneuvers.back());
 }
 
-ros::Time get_plan_start_time(const cav_msgs::ManeuverPlan &plan)
+const ros::Time& get_plan_start_time(const cav_msgs::ManeuverPlan &plan)
 {
     if (plan.maneuvers.empty())
     {
         throw std::invalid_argument("cost_plugin_system::get_plan_start_time called on empty maneuver plan");
     }
 
-    cav_msgs::Maneuver m = plan.maneuvers.front();
-    return get_maneuver_start_time(m);
+    return get_maneuver_start_time(plan.maneuvers.front());
 }
 
 double get_plan_start_distance(const cav_msgs::ManeuverPlan &plan)
@@ -61,72 +84,23 @@ double get_plan_start_distance(const cav_msgs::ManeuverPlan &plan)
         throw std::invalid_argument("cost_plugin_system::get_plan_start_dist called on empty maneuver plan");
     }
 
-    cav_msgs::Maneuver m = plan.maneuvers.front();
-    return get_maneuver_start_distance(m);
+    return get_maneuver_start_distance(plan.maneuvers.front());
 }
 
-ros::Time get_maneuver_end_time(const cav_msgs::Maneuver &mvr)
-{
-    return GET_MANEUVER_PROPERTY(mvr, end_time);
-}
+COST_UTILS_DEFINE_MANEUVER_ACCESSOR(const ros::Time&, get_maneuver_end_time, COST_UTILS_RETURN_FIELD_CASE, end_time)
 
-ros::Time get_maneuver_start_time(const cav_msgs::Maneuver &mvr)
-{
-    return GET_MANEUVER_PROPERTY(mvr, start_time);
-}
+COST_UTILS_DEFINE_MANEUVER_ACCESSOR(const ros::Time&, get_maneuver_start_time, COST_UTILS_RETURN_FIELD_CASE, start_time)
 
-double get_maneuver_end_distance(const cav_msgs::Maneuver &mvr)
-{
-    return GET_MANEUVER_PROPERTY(mvr, end_dist);
-}
+COST_UTILS_DEFINE_MANEUVER_ACCESSOR(double, get_maneuver_end_distance, COST_UTILS_RETURN_FIELD_CASE, end_dist)
 
-double get_maneuver_start_distance(const cav_msgs::Maneuver &mvr)
-{
-    return GET_MANEUVER_PROPERTY(mvr, start_dist);
-}
+COST_UTILS_DEFINE_MANEUVER_ACCESSOR(double, get_maneuver_start_distance, COST_UTILS_RETURN_FIELD_CASE, start_dist)
 
-double get_maneuver_start_speed(const cav_msgs::Maneuver &mvr)
-{
-    return GET_MANEUVER_PROPERTY(mvr, start_speed);
-}
+COST_UTILS_DEFINE_MANEUVER_ACCESSOR(double, get_maneuver_start_speed, COST_UTILS_RETURN_FIELD_CASE, start_speed)
 
-double get_maneuver_end_speed(const cav_msgs::Maneuver &mvr)
-{
-    return GET_MANEUVER_PROPERTY(mvr, end_speed);
-}
+COST_UTILS_DEFINE_MANEUVER_ACCESSOR(double, get_maneuver_end_speed, COST_UTILS_RETURN_FIELD_CASE, end_speed)
 
-std::string get_maneuver_starting_lane_id(const cav_msgs::Maneuver &mvr)
-{
-    if (mvr.type == cav_msgs::Maneuver::LANE_FOLLOWING){
-        return mvr.lane_following_maneuver.lane_id;
-    } else if (mvr.type == cav_msgs::Maneuver::INTERSECTION_TRANSIT_LEFT_TURN) {
-        return mvr.intersection_transit_left_turn_maneuver.starting_lane_id;
-    } else if (mvr.type == cav_msgs::Maneuver::INTERSECTION_TRANSIT_RIGHT_TURN) {
-        return mvr.intersection_transit_right_turn_maneuver.starting_lane_id;
-    } else if (mvr.type == cav_msgs::Maneuver::INTERSECTION_TRANSIT_STRAIGHT) {
-        return mvr.intersection_transit_straight_maneuver.starting_lane_id;
-    } else if (mvr.type == cav_msgs::Maneuver::LANE_CHANGE) {
-        return mvr.lane_change_maneuver.starting_lane_id;
-    } 
-
-    throw std::invalid_argument("Trying to get starting_lane_id of maneuver with invalid type.");
-}
+COST_UTILS_DEFINE_MANEUVER_ACCESSOR(const std::string&, get_maneuver_starting_lane_id, COST_UTILS_RETURN_STARTING_LANE_CASE, unused)
 
-std::string get_maneuver_ending_lane_id(const cav_msgs::Maneuver &mvr)
-{
-    if (mvr.type == cav_msgs::Maneuver::LANE_FOLLOWING){
-        return mvr.lane_following_maneuver.lane_id;
-    } else if (mvr.type == cav_msgs::Maneuver::INTERSECTION_TRANSIT_LEFT_TURN) {
-        return mvr.intersection_transit_left_turn_maneuver.ending_lane_id;
-    } else if (mvr.type == cav_msgs::Maneuver::INTERSECTION_TRANSIT_RIGHT_TURN) {
-        return mvr.intersection_transit_right_turn_maneuver.ending_lane_id;
-    } else if (mvr.type == cav_msgs::Maneuver::INTERSECTION_TRANSIT_STRAIGHT) {
-        return mvr.intersection_transit_straight_maneuver.ending_lane_id;
-    } else if (mvr.type == cav_msgs::Maneuver::LANE_CHANGE) {
-        return mvr.lane_change_maneuver.ending_lane_id;
-    } 
-
-    throw std::invalid_argument("Trying to get ending_lane_id of maneuver with invalid type.");
-}
+COST_UTILS_DEFINE_MANEUVER_ACCESSOR(const std::string&, get_maneuver_ending_lane_id, COST_UTILS_RETURN_ENDING_LANE_CASE, unused)
 
 } // namespace cost_utils
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2018-2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include "maneuver_columns.hpp"
+#include "cost_utils.hpp"
+
+namespace cost_plugin_system
+{
+
+void ManeuverColumns::clear()
+{
+    start_time.clear();
+    end_time.clear();
+    start_speed.clear();
+    end_speed.clear();
+    lane_change.clear();
+    plan_offsets.assign(1, 0);
+}
+
+void ManeuverColumns::reserve(size_t maneuver_count, size_t plan_count)
+{
+    start_time.reserve(maneuver_count);
+    end_time.reserve(maneuver_count);
+    start_speed.reserve(maneuver_count);
+    end_speed.reserve(maneuver_count);
+    lane_change.reserve(maneuver_count);
+    plan_offsets.reserve(plan_count + 1);
+}
+
+void ManeuverColumns::append(const cav_msgs::ManeuverPlan& plan)
+{
+    for (const cav_msgs::Maneuver& mvr : plan.maneuvers)
+    {
+        start_time.push_back(cost_utils::get_maneuver_start_time(mvr).toSec());
+        end_time.push_back(cost_utils::get_maneuver_end_time(mvr).toSec());
+        start_speed.push_back(cost_utils::get_maneuver_start_speed(mvr));
+        end_speed.push_back(cost_utils::get_maneuver_end_speed(mvr));
+        lane_change.push_back(
+            cost_utils::get_maneuver_starting_lane_id(mvr).compare(cost_utils::get_maneuver_ending_lane_id(mvr)) != 0 ? 1 : 0);
+    }
+    plan_offsets.push_back(start_speed.size());
+}
+
+size_t ManeuverColumns::plan_count() const
+{
+    return plan_offsets.size() - 1;
+}
+} // namespace cost_plugin_system
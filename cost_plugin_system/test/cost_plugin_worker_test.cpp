@@ -16,6 +16,13 @@
 
 #include <gtest/gtest.h>
 #include "cost_plugin_worker.hpp"
+#include "cost_evaluator.hpp"
+#include "cost_comfort.hpp"
+#include "cost_efficiency.hpp"
+#include "cost_feasibility.hpp"
+#include "cost_fuel.hpp"
+#include "cost_safety.hpp"
+#include "cost_utils.hpp"
 
 namespace cost_plugin_system
 {
@@ -75,4 +82,119 @@ TEST(CostPluginWorkerTest, testMixedPlanners)
 
     ASSERT_NEAR(0.981, cost, 0.01);
 }
+
+TEST(CostPluginWorkerTest, testBatchEvaluation)
+{
+    cost_plugin_system::CostEvaluator evaluator;
+    ros::Time::init();
+    cav_msgs::Maneuver mvr1;
+    mvr1.type = cav_msgs::Maneuver::LANE_FOLLOWING;
+    mvr1.lane_following_maneuver.start_dist = 0;
+    mvr1.lane_following_maneuver.start_time = ros::Time(0);
+    mvr1.lane_following_maneuver.lane_id.push_back(0);
+    mvr1.lane_following_maneuver.end_dist = 1;
+    mvr1.lane_following_maneuver.end_time = ros::Time(1.0);
+    mvr1.lane_following_maneuver.start_speed = 10;
+    mvr1.lane_following_maneuver.end_speed = 10;
+
+    cav_msgs::Maneuver mvr2 = mvr1;
+    mvr2.lane_following_maneuver.start_dist = 1;
+    mvr2.lane_following_maneuver.start_time = ros::Time(1.0);
+    mvr2.lane_following_maneuver.end_dist = 20;
+    mvr2.lane_following_maneuver.end_time = ros::Time(2.0);
+    mvr2.lane_following_maneuver.end_speed = 20;
+
+    std::vector<cav_msgs::ManeuverPlan> plans(2);
+    plans[0].maneuvers.push_back(mvr1);
+    plans[1].maneuvers.push_back(mvr1);
+    plans[1].maneuvers.push_back(mvr2);
+
+    std::vector<double> costs = evaluator.compute_costs(plans);
+
+    ASSERT_EQ(2, costs.size());
+    EXPECT_DOUBLE_EQ(evaluator.compute_cost(plans[0]), costs[0]);
+    EXPECT_DOUBLE_EQ(evaluator.compute_cost(plans[1]), costs[1]);
+
+    std::vector<const cav_msgs::ManeuverPlan*> plan_ptrs = {&plans[1], &plans[0]};
+    std::vector<double> reordered_costs = evaluator.compute_costs(plan_ptrs);
+    ASSERT_EQ(2, reordered_costs.size());
+    EXPECT_DOUBLE_EQ(costs[1], reordered_costs[0]);
+    EXPECT_DOUBLE_EQ(costs[0], reordered_costs[1]);
+}
+
+TEST(CostPluginWorkerTest, testFusedTermsMatchCostPlugins)
+{
+    ros::Time::init();
+    cost_plugin_system::CostEvaluatorConfig config;
+    config.weight_of_comfort = 1.0;
+    config.weight_of_efficiency = 2.0;
+    config.weight_of_feasibility = 3.0;
+    config.weight_of_fuel = 4.0;
+    config.weight_of_safety = 5.0;
+    cost_plugin_system::CostEvaluator evaluator(config);
+
+    cav_msgs::ManeuverPlan plan;
+    cav_msgs::Maneuver mvr1;
+    mvr1.type = cav_msgs::Maneuver::LANE_FOLLOWING;
+    mvr1.lane_following_maneuver.start_dist = 0;
+    mvr1.lane_following_maneuver.start_time = ros::Time(0);
+    mvr1.lane_following_maneuver.lane_id = "1";
+    mvr1.lane_following_maneuver.end_dist = 50;
+    mvr1.lane_following_maneuver.end_time = ros::Time(4.0);
+    mvr1.lane_following_maneuver.start_speed = 10;
+    mvr1.lane_following_maneuver.end_speed = 26;
+
+    cav_msgs::Maneuver mvr2;
+    mvr2.type = cav_msgs::Maneuver::LANE_CHANGE;
+    mvr2.lane_change_maneuver.start_dist = 50;
+    mvr2.lane_change_maneuver.start_time = ros::Time(4.0);
+    mvr2.lane_change_maneuver.starting_lane_id = "1";
+    mvr2.lane_change_maneuver.ending_lane_id = "2";
+    mvr2.lane_change_maneuver.end_dist = 150;
+    mvr2.lane_change_maneuver.end_time = ros::Time(8.0);
+    mvr2.lane_change_maneuver.start_speed = 26;
+    mvr2.lane_change_maneuver.end_speed = 30;
+
+    plan.maneuvers.push_back(mvr1);
+    plan.maneuvers.push_back(mvr2);
+
+    double expected = config.weight_of_comfort * cost_plugin_system::CostofComfort(config.max_decelaration).compute_cost(plan) +
+                      config.weight_of_efficiency * cost_plugin_system::CostofEfficiency(config.speed_limit, config.speed_buffer).compute_cost(plan) +
+                      config.weight_of_feasibility * cost_plugin_system::CostofFeasibility(config.max_accelaration, config.max_decelaration).compute_cost(plan) +
+                      config.weight_of_fuel * cost_plugin_system::CostofFuel().compute_cost(plan) +
+                      config.weight_of_safety * cost_plugin_system::CostofSafety(config.speed_limit).compute_cost(plan);
+
+    EXPECT_NEAR(expected, evaluator.compute_cost(plan), 1e-9);
+
+    cost_plugin_system::ManeuverColumns columns;
+    columns.append(plan);
+    columns.append(plan);
+    ASSERT_EQ(2, columns.plan_count());
+    EXPECT_EQ(0, columns.lane_change[2]);
+    EXPECT_EQ(1, columns.lane_change[3]);
+    std::vector<double> costs = evaluator.compute_costs(columns);
+    ASSERT_EQ(2, costs.size());
+    EXPECT_NEAR(expected, costs[0], 1e-9);
+    EXPECT_NEAR(expected, costs[1], 1e-9);
+}
+
+TEST(CostPluginWorkerTest, testManeuverAccessorsReferenceFields)
+{
+    cav_msgs::ManeuverPlan plan;
+    cav_msgs::Maneuver mvr;
+    mvr.type = cav_msgs::Maneuver::LANE_CHANGE;
+    mvr.lane_change_maneuver.starting_lane_id = "1";
+    mvr.lane_change_maneuver.ending_lane_id = "2";
+    mvr.lane_change_maneuver.end_time = ros::Time(2.0);
+    plan.maneuvers.push_back(mvr);
+
+    const cav_msgs::Maneuver& stored = plan.maneuvers.back();
+    EXPECT_EQ(&stored.lane_change_maneuver.starting_lane_id, &cost_utils::get_maneuver_starting_lane_id(stored));
+    EXPECT_EQ(&stored.lane_change_maneuver.ending_lane_id, &cost_utils::get_maneuver_ending_lane_id(stored));
+    EXPECT_EQ(&stored.lane_change_maneuver.end_time, &cost_utils::get_plan_end_time(plan));
+
+    cav_msgs::Maneuver invalid;
+    invalid.type = cav_msgs::Maneuver::STOP_AND_WAIT;
+    EXPECT_THROW(cost_utils::get_maneuver_start_speed(invalid), std::invalid_argument);
+}
 } // namespace cost_plugin_system
\ No newline at end of file
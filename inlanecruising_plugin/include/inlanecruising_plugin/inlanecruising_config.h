@@ -42,6 +42,8 @@ struct InLaneCruisingPluginConfig
                                            // computed curvature and output speeds
   int curvature_calc_lookahead_count = 1;  // Number of points to look ahead when calculating the curvature
                                            // of the lanelet centerline
+  int nearest_point_search_window = 10;    // Number of points to evaluate past the current best point when searching
+                                           // for the point nearest the vehicle
 
   friend std::ostream& operator<<(std::ostream& output, const InLaneCruisingPluginConfig& c)
   {
@@ -59,6 +61,7 @@ struct InLaneCruisingPluginConfig
            << "lateral_accel_limit: " << c.lateral_accel_limit << std::endl
            << "moving_average_window_size: " << c.moving_average_window_size << std::endl
            << "curvature_calc_lookahead_count: " << c.curvature_calc_lookahead_count << std::endl
+           << "nearest_point_search_window: " << c.nearest_point_search_window << std::endl
            << "}" << std::endl;
     return output;
   }
@@ -162,8 +162,10 @@ public:
 
   /**
    * \brief Returns the nearest point to the provided vehicle pose in the provided list
+   *        The search begins at the front of the list and stops once config.nearest_point_search_window points
+   *        have been evaluated past the best point found so far
    * 
-   * \param points The points to evaluate
+   * \param points The points to evaluate. Expected to be ordered along the route starting near the vehicle
    * \param state The current vehicle state
    * 
    * \return index of nearest point in points
@@ -64,6 +64,8 @@ public:
     pnh.param<double>("/vehicle_lateral_accel_limit", config.lateral_accel_limit, config.lateral_accel_limit);
     pnh.param<int>("curvature_calc_lookahead_count", config.curvature_calc_lookahead_count,
                         config.curvature_calc_lookahead_count);
+    pnh.param<int>("nearest_point_search_window", config.nearest_point_search_window,
+                        config.nearest_point_search_window);
 
     ROS_INFO_STREAM("InLaneCruisingPlugin Params" << config);
     
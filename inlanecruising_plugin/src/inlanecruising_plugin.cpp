@@ -565,14 +565,22 @@ int InLaneCruisingPlugin::getNearestPointIndex(const std::vector<PointSpeedPair>
 {
   lanelet::BasicPoint2d veh_point(state.X_pos_global, state.Y_pos_global);
   ROS_DEBUG_STREAM("veh_point: " << veh_point.x() << ", " << veh_point.y());
-  double min_distance = std::numeric_limits<double>::max();
-  int i = 0;
-  int best_index = 0;
-  for (const auto& p : points)
+
+  if (points.empty())
   {
-    double distance = lanelet::geometry::distance2d(p.point, veh_point);
-    ROS_DEBUG_STREAM("distance: " << distance);
-    ROS_DEBUG_STREAM("p: " << p.point.x() << ", " << p.point.y());
+    return 0;
+  }
+
+  // The points are generated starting at the lanelet containing the vehicle so the nearest point is close to the front
+  // of the list. Walk forward while the distance decreases and only look a bounded window past any local minimum
+  // instead of evaluating every point of every maneuver.
+  size_t window = static_cast<size_t>(std::max(config_.nearest_point_search_window, 1));
+  double min_distance = lanelet::geometry::distance2d(points[0].point, veh_point);
+  size_t best_index = 0;
+  size_t i = 1;
+  while (i < points.size() && i <= best_index + window)
+  {
+    double distance = lanelet::geometry::distance2d(points[i].point, veh_point);
     if (distance < min_distance)
     {
       best_index = i;
@@ -581,10 +589,11 @@ int InLaneCruisingPlugin::getNearestPointIndex(const std::vector<PointSpeedPair>
     i++;
   }
 
+  ROS_DEBUG_STREAM("Nearest point search evaluated " << i << " of " << points.size() << " points with distance: " << min_distance);
+
   return best_index;
 }
 
-
 void InLaneCruisingPlugin::splitPointSpeedPairs(const std::vector<PointSpeedPair>& points,
                                                 std::vector<lanelet::BasicPoint2d>* basic_points,
                                                 std::vector<double>* speeds)
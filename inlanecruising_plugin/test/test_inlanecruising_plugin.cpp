@@ -216,6 +216,37 @@ TEST(InLaneCruisingPluginTest, getNearestPointIndex)
   ASSERT_EQ(3, plugin.getNearestPointIndex(points, state));
 }
 
+TEST(InLaneCruisingPluginTest, getNearestPointIndexWindow)
+{
+  InLaneCruisingPluginConfig config;
+  config.downsample_ratio = 1;
+  config.nearest_point_search_window = 2;
+  std::shared_ptr<carma_wm::CARMAWorldModel> wm = std::make_shared<carma_wm::CARMAWorldModel>();
+  InLaneCruisingPlugin plugin(wm, config, [&](auto msg) {});
+
+  std::vector<PointSpeedPair> points;
+
+  PointSpeedPair p;
+  p.speed = 1.0;
+  for (int i = 0; i < 10; i++)  // Straight line along x
+  {
+    p.point = lanelet::BasicPoint2d(i, 0);
+    points.push_back(p);
+  }
+  for (int i = 10; i >= 0; i--)  // Path loops back along y = 0.5
+  {
+    p.point = lanelet::BasicPoint2d(i, 0.5);
+    points.push_back(p);
+  }
+
+  cav_msgs::VehicleState state;
+  state.X_pos_global = 2.1;
+  state.Y_pos_global = 0.3;
+
+  // The later point (2, 0.5) is nearer but lies outside the search window of the local minimum
+  ASSERT_EQ(2, plugin.getNearestPointIndex(points, state));
+}
+
 TEST(InLaneCruisingPluginTest, get_lookahead_speed)
 {
   InLaneCruisingPluginConfig config;
@@ -18,12 +18,17 @@
 #define PLAN_DELEGATOR_INCLUDE_PLAN_DELEGATOR_HPP_
 
 #include <unordered_map>
+#include <map>
+#include <array>
+#include <vector>
+#include <future>
 #include <math.h>
 #include <ros/ros.h>
 #include <cav_msgs/ManeuverPlan.h>
 #include <cav_msgs/GuidanceState.h>
 #include <cav_srvs/PlanTrajectory.h>
 #include <carma_utils/CARMAUtils.h>
+#include <diagnostic_msgs/DiagnosticArray.h>
 #include <geometry_msgs/PoseStamped.h>
 #include <geometry_msgs/TwistStamped.h>
 
@@ -44,6 +49,34 @@
 
 namespace plan_delegator
 {
+    // upper bounds of the plugin call latency histogram buckets, an additional bucket collects all slower calls
+    static constexpr std::array<double, 7> LATENCY_BUCKET_BOUNDS_MS = {5.0, 10.0, 20.0, 50.0, 100.0, 200.0, 500.0};
+
+    /**
+     * \brief Latency statistics of the PlanTrajectory service calls made to a single trajectory planner
+     */
+    struct PlannerCallLatency
+    {
+        std::array<uint64_t, LATENCY_BUCKET_BOUNDS_MS.size() + 1> bucket_counts {};
+        uint64_t call_count = 0;
+        uint64_t failure_count = 0;
+        double total_latency_ms = 0.0;
+        double max_latency_ms = 0.0;
+    };
+
+    /**
+     * \brief Start state of a trajectory segment together with the maneuver the segment is planned for
+     */
+    struct JunctionState
+    {
+        cav_msgs::VehicleState vehicle_state;
+        // target time of the last point of the preceding segment
+        ros::Time target_time;
+        // the maneuver start time keys the junction states, its end time and planner identify the maneuver further
+        ros::Time maneuver_end_time;
+        std::string planner;
+    };
+
     class PlanDelegator
     {
         public:
@@ -80,6 +113,24 @@ namespace plan_delegator
              */
             ros::ServiceClient& getPlannerClientByName(const std::string& planner_name);
 
+            /**
+             * \brief Call the PlanTrajectory service of the specified planner, reconnecting once if its
+             * persistent connection has been dropped. The call latency is added to the planner's histogram
+             * \return if the service call was successful
+             */
+            bool callPlanner(const std::string& planner_name, cav_srvs::PlanTrajectory& plan_req);
+
+            /**
+             * \brief Add a PlanTrajectory service call latency to the histogram of the specified planner
+             */
+            void recordPlannerCallLatency(const std::string& planner_name, double latency_ms, bool success);
+
+            /**
+             * \brief Generate a diagnostic report with one status per planner containing its call latency histogram
+             * \return a DiagnosticArray object which is ready to be published
+             */
+            diagnostic_msgs::DiagnosticArray composeLatencyReport() const;
+
             /**
              * \brief Example if a maneuver end time has passed current system time
              * \return if input maneuver is expires
@@ -92,13 +143,67 @@ namespace plan_delegator
              */
             cav_srvs::PlanTrajectory composePlanTrajectoryRequest(const cav_msgs::TrajectoryPlan& latest_trajectory_plan) const;
 
+            /**
+             * \brief Generate the vehicle state the next trajectory segment should start from based on current planning progress
+             * \return the current vehicle state if no trajectory has been planned, otherwise the state at the end of the trajectory
+             */
+            cav_msgs::VehicleState composeVehicleState(const cav_msgs::TrajectoryPlan& latest_trajectory_plan) const;
+
+            /**
+             * \brief Generate new PlanTrajecory service request which starts from the provided vehicle state
+             * \return a PlanTrajectory object which is ready to be used in the following service call
+             */
+            cav_srvs::PlanTrajectory composePlanTrajectoryRequest(const cav_msgs::VehicleState& vehicle_state) const;
+
+            /**
+             * \brief Generate the junction state of a trajectory segment which starts from the provided vehicle state
+             * \return the junction state of the maneuver which starts at the end of the trajectory under construction
+             */
+            JunctionState composeJunctionState(const cav_msgs::VehicleState& vehicle_state, const cav_msgs::TrajectoryPlan& latest_trajectory_plan,
+                                               const cav_msgs::Maneuver& maneuver) const;
+
+            /**
+             * \brief Check if a junction state was recorded for the provided maneuver
+             * \return true if the maneuver end time and planner match those of the junction state
+             */
+            bool isJunctionOfManeuver(const JunctionState& junction_state, const cav_msgs::Maneuver& maneuver) const;
+
+            /**
+             * \brief Check if the speculative start state used to plan a trajectory segment is close enough
+             * to the end state of the preceding segment for the two segments to be stitched together
+             * \return true if the positions, longitudinal speeds and target times differ by no more than
+             * the configured junction tolerances
+             */
+            bool isJunctionWithinTolerance(const JunctionState& speculative_state, const JunctionState& actual_state) const noexcept;
+
         protected:
-        
+
+            /**
+             * \brief Plan trajectory based on latest maneuver plan via ROS service call to plugins
+             * \return a TrajectoryPlan object which contains PlanTrajectory response from plugins
+             */
+            cav_msgs::TrajectoryPlan planTrajectory();
+
+            /**
+             * \brief Plan trajectory by calling the plugins of all later maneuvers concurrently using the segment
+             * start states from the previous planning cycle. Segments whose junction with the preceding segment
+             * deviates beyond the junction tolerance, or whose call has not returned within the speculative call
+             * timeout, are replanned sequentially
+             * \return a TrajectoryPlan object which contains PlanTrajectory response from plugins
+             */
+            cav_msgs::TrajectoryPlan planTrajectorySpeculative();
+
             // ROS params
             std::string planning_topic_prefix_ = "";
             std::string planning_topic_suffix_ = "";
             double spin_rate_ = 10.0;
             double max_trajectory_duration_ = 6.0;
+            bool speculative_planning_ = false;
+            double junction_tolerance_ = 0.5;
+            double junction_speed_tolerance_ = 0.5;
+            double junction_time_tolerance_ = 0.2;
+            double speculative_call_timeout_ = 0.05;
+            double latency_report_period_ = 1.0;
 
             // map to store service clients
             std::unordered_map<std::string, ros::ServiceClient> trajectory_planners_;
@@ -107,6 +212,18 @@ namespace plan_delegator
             geometry_msgs::PoseStamped latest_pose_;
             geometry_msgs::TwistStamped latest_twist_;
 
+            // segment start states computed in the previous planning cycle keyed by maneuver start time
+            // used as the speculative start states when speculative planning is enabled
+            std::map<ros::Time, JunctionState> junction_states_;
+
+            // speculative calls which timed out or were no longer needed, kept until they finish
+            // as destroying the future of an unfinished asynchronous call blocks
+            std::vector<std::future<bool>> abandoned_speculative_calls_;
+
+            // call latency statistics keyed by planner name
+            std::unordered_map<std::string, PlannerCallLatency> planner_call_latencies_;
+            ros::Time last_latency_report_time_;
+
         private:
 
             // nodehandle and private nodehandle
@@ -115,6 +232,7 @@ namespace plan_delegator
 
             // ROS subscribers and publishers
             ros::Publisher traj_pub_;
+            ros::Publisher latency_pub_;
             ros::Subscriber plan_sub_;
             ros::Subscriber pose_sub_;
             ros::Subscriber twist_sub_;
@@ -147,10 +265,10 @@ namespace plan_delegator
             bool isTrajectoryLongEnough(const cav_msgs::TrajectoryPlan& plan) const noexcept;
 
             /**
-             * \brief Plan trajectory based on latest maneuver plan via ROS service call to plugins
-             * \return a TrajectoryPlan object which contains PlanTrajectory response from plugins
+             * \brief Move a trajectory segment returned by a plugin to the end of the trajectory under construction
+             * \return false if the segment is invalid and planning should stop
              */
-            cav_msgs::TrajectoryPlan planTrajectory();
+            bool appendTrajectorySegment(cav_msgs::TrajectoryPlan& latest_trajectory_plan, cav_msgs::TrajectoryPlan&& segment) const;
 
     };
 }
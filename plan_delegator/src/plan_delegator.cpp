@@ -15,6 +15,10 @@
  */
 
 #include <stdexcept>
+#include <algorithm>
+#include <future>
+#include <chrono>
+#include <memory>
 #include <carma_wm/Geometry.h>
 #include "plan_delegator.hpp"
 
@@ -30,8 +34,15 @@ namespace plan_delegator
         pnh_.param<std::string>("planning_topic_suffix", planning_topic_suffix_, "/plan_trajectory");
         pnh_.param<double>("spin_rate", spin_rate_, 10.0);
         pnh_.param<double>("trajectory_duration_threshold", max_trajectory_duration_, 6.0);
+        pnh_.param<bool>("speculative_planning", speculative_planning_, false);
+        pnh_.param<double>("junction_tolerance", junction_tolerance_, 0.5);
+        pnh_.param<double>("junction_speed_tolerance", junction_speed_tolerance_, 0.5);
+        pnh_.param<double>("junction_time_tolerance", junction_time_tolerance_, 0.2);
+        pnh_.param<double>("speculative_call_timeout", speculative_call_timeout_, 0.05);
+        pnh_.param<double>("latency_report_period", latency_report_period_, 1.0);
 
         traj_pub_ = nh_.advertise<cav_msgs::TrajectoryPlan>("plan_trajectory", 5);
+        latency_pub_ = nh_.advertise<diagnostic_msgs::DiagnosticArray>("plugin_call_latency", 1);
         plan_sub_ = nh_.subscribe("final_maneuver_plan", 5, &PlanDelegator::maneuverPlanCallback, this);
         twist_sub_ = nh_.subscribe<geometry_msgs::TwistStamped>("current_velocity", 5,
             [this](const geometry_msgs::TwistStampedConstPtr& twist) {this->latest_twist_ = *twist;});
@@ -76,12 +87,78 @@ namespace plan_delegator
         if(trajectory_planners_.find(planner_name) == trajectory_planners_.end())
         {
             ROS_INFO_STREAM("Discovered new trajectory planner: " << planner_name);
+            // persistent clients keep their TCPROS connection open between planning cycles
             trajectory_planners_.emplace(
-                planner_name, nh_.serviceClient<cav_srvs::PlanTrajectory>(planning_topic_prefix_ + planner_name + planning_topic_suffix_));
+                planner_name, nh_.serviceClient<cav_srvs::PlanTrajectory>(planning_topic_prefix_ + planner_name + planning_topic_suffix_, true));
         }
         return trajectory_planners_[planner_name];
     }
 
+    bool PlanDelegator::callPlanner(const std::string& planner_name, cav_srvs::PlanTrajectory& plan_req)
+    {
+        ros::ServiceClient& client = getPlannerClientByName(planner_name);
+        ros::WallTime start_time = ros::WallTime::now();
+        bool success = client.call(plan_req);
+        if(!success && !client.isValid())
+        {
+            // a persistent connection is not reestablished once dropped, for example when the plugin restarts
+            ROS_WARN_STREAM("Reconnecting to trajectory planner: " << planner_name);
+            client = nh_.serviceClient<cav_srvs::PlanTrajectory>(client.getService(), true);
+            success = client.call(plan_req);
+        }
+        recordPlannerCallLatency(planner_name, (ros::WallTime::now() - start_time).toSec() / MILLISECOND_TO_SECOND, success);
+        return success;
+    }
+
+    void PlanDelegator::recordPlannerCallLatency(const std::string& planner_name, double latency_ms, bool success)
+    {
+        auto& histogram = planner_call_latencies_[planner_name];
+        size_t bucket = 0;
+        while(bucket < LATENCY_BUCKET_BOUNDS_MS.size() && latency_ms > LATENCY_BUCKET_BOUNDS_MS[bucket])
+        {
+            ++bucket;
+        }
+        ++histogram.bucket_counts[bucket];
+        ++histogram.call_count;
+        if(!success)
+        {
+            ++histogram.failure_count;
+        }
+        histogram.total_latency_ms += latency_ms;
+        histogram.max_latency_ms = std::max(histogram.max_latency_ms, latency_ms);
+    }
+
+    diagnostic_msgs::DiagnosticArray PlanDelegator::composeLatencyReport() const
+    {
+        diagnostic_msgs::DiagnosticArray report;
+        report.header.stamp = ros::Time::now();
+        for(const auto& planner : planner_call_latencies_)
+        {
+            diagnostic_msgs::DiagnosticStatus status;
+            status.name = planner.first;
+            status.hardware_id = planning_topic_prefix_ + planner.first + planning_topic_suffix_;
+            status.level = planner.second.failure_count == 0 ? diagnostic_msgs::DiagnosticStatus::OK : diagnostic_msgs::DiagnosticStatus::WARN;
+            auto add_value = [&status](const std::string& key, const std::string& value)
+            {
+                diagnostic_msgs::KeyValue kv;
+                kv.key = key;
+                kv.value = value;
+                status.values.push_back(kv);
+            };
+            add_value("calls", std::to_string(planner.second.call_count));
+            add_value("failures", std::to_string(planner.second.failure_count));
+            add_value("mean_ms", std::to_string(planner.second.call_count == 0 ? 0.0 : planner.second.total_latency_ms / planner.second.call_count));
+            add_value("max_ms", std::to_string(planner.second.max_latency_ms));
+            for(size_t i = 0; i < LATENCY_BUCKET_BOUNDS_MS.size(); ++i)
+            {
+                add_value("le_" + std::to_string(static_cast<int>(LATENCY_BUCKET_BOUNDS_MS[i])) + "_ms", std::to_string(planner.second.bucket_counts[i]));
+            }
+            add_value("gt_" + std::to_string(static_cast<int>(LATENCY_BUCKET_BOUNDS_MS.back())) + "_ms", std::to_string(planner.second.bucket_counts.back()));
+            report.status.push_back(status);
+        }
+        return report;
+    }
+
     bool PlanDelegator::isManeuverPlanValid(const cav_msgs::ManeuverPlanConstPtr& maneuver_plan) const noexcept
     {
         // currently it only checks if maneuver list is empty
@@ -99,43 +176,99 @@ namespace plan_delegator
         return GET_MANEUVER_PROPERTY(maneuver, end_time) <= current_time;
     }
 
-    cav_srvs::PlanTrajectory PlanDelegator::composePlanTrajectoryRequest(const cav_msgs::TrajectoryPlan& latest_trajectory_plan) const
+    cav_msgs::VehicleState PlanDelegator::composeVehicleState(const cav_msgs::TrajectoryPlan& latest_trajectory_plan) const
     {
-        auto plan_req = cav_srvs::PlanTrajectory{};
-        plan_req.request.maneuver_plan = latest_maneuver_plan_;
+        cav_msgs::VehicleState vehicle_state;
         // set current vehicle state if we have NOT planned any previous trajectories
         if(latest_trajectory_plan.trajectory_points.empty())
         {
-            plan_req.request.vehicle_state.longitudinal_vel = latest_twist_.twist.linear.x;
-            plan_req.request.vehicle_state.X_pos_global = latest_pose_.pose.position.x;
-            plan_req.request.vehicle_state.Y_pos_global = latest_pose_.pose.position.y;
+            vehicle_state.longitudinal_vel = latest_twist_.twist.linear.x;
+            vehicle_state.X_pos_global = latest_pose_.pose.position.x;
+            vehicle_state.Y_pos_global = latest_pose_.pose.position.y;
             double roll, pitch, yaw;
             carma_wm::geometry::rpyFromQuaternion(latest_pose_.pose.orientation, roll, pitch, yaw);
-            plan_req.request.vehicle_state.orientation = yaw;
+            vehicle_state.orientation = yaw;
         }
         // set vehicle state based on last two planned trajectory points
         else
         {
-            cav_msgs::TrajectoryPlanPoint last_point = latest_trajectory_plan.trajectory_points.back();
-            cav_msgs::TrajectoryPlanPoint second_last_point = *(latest_trajectory_plan.trajectory_points.rbegin() + 1);
-            plan_req.request.vehicle_state.X_pos_global = last_point.x;
-            plan_req.request.vehicle_state.Y_pos_global = last_point.y;
+            const cav_msgs::TrajectoryPlanPoint& last_point = latest_trajectory_plan.trajectory_points.back();
+            const cav_msgs::TrajectoryPlanPoint& second_last_point = *(latest_trajectory_plan.trajectory_points.rbegin() + 1);
+            vehicle_state.X_pos_global = last_point.x;
+            vehicle_state.Y_pos_global = last_point.y;
             auto distance_diff = std::sqrt(std::pow(last_point.x - second_last_point.x, 2) + std::pow(last_point.y - second_last_point.y, 2));
             ros::Duration time_diff = last_point.target_time - second_last_point.target_time;
             auto time_diff_sec = time_diff.toSec();
             // this assumes the vehicle does not have significant lateral velocity
-            plan_req.request.vehicle_state.longitudinal_vel = distance_diff / time_diff_sec;
+            vehicle_state.longitudinal_vel = distance_diff / time_diff_sec;
             // TODO develop way to set yaw value for future points
         }
+        return vehicle_state;
+    }
+
+    cav_srvs::PlanTrajectory PlanDelegator::composePlanTrajectoryRequest(const cav_msgs::TrajectoryPlan& latest_trajectory_plan) const
+    {
+        return composePlanTrajectoryRequest(composeVehicleState(latest_trajectory_plan));
+    }
+
+    cav_srvs::PlanTrajectory PlanDelegator::composePlanTrajectoryRequest(const cav_msgs::VehicleState& vehicle_state) const
+    {
+        auto plan_req = cav_srvs::PlanTrajectory{};
+        plan_req.request.maneuver_plan = latest_maneuver_plan_;
+        plan_req.request.vehicle_state = vehicle_state;
         return plan_req;
     }
 
+    JunctionState PlanDelegator::composeJunctionState(const cav_msgs::VehicleState& vehicle_state, const cav_msgs::TrajectoryPlan& latest_trajectory_plan,
+                                                      const cav_msgs::Maneuver& maneuver) const
+    {
+        JunctionState junction_state;
+        junction_state.vehicle_state = vehicle_state;
+        if(!latest_trajectory_plan.trajectory_points.empty())
+        {
+            junction_state.target_time = latest_trajectory_plan.trajectory_points.back().target_time;
+        }
+        junction_state.maneuver_end_time = GET_MANEUVER_PROPERTY(maneuver, end_time);
+        junction_state.planner = GET_MANEUVER_PROPERTY(maneuver, parameters.planning_tactical_plugin);
+        return junction_state;
+    }
+
+    bool PlanDelegator::isJunctionOfManeuver(const JunctionState& junction_state, const cav_msgs::Maneuver& maneuver) const
+    {
+        return junction_state.maneuver_end_time == GET_MANEUVER_PROPERTY(maneuver, end_time) &&
+               junction_state.planner == GET_MANEUVER_PROPERTY(maneuver, parameters.planning_tactical_plugin);
+    }
+
+    bool PlanDelegator::isJunctionWithinTolerance(const JunctionState& speculative_state, const JunctionState& actual_state) const noexcept
+    {
+        auto distance = std::sqrt(std::pow(speculative_state.vehicle_state.X_pos_global - actual_state.vehicle_state.X_pos_global, 2) +
+                                  std::pow(speculative_state.vehicle_state.Y_pos_global - actual_state.vehicle_state.Y_pos_global, 2));
+        auto speed_diff = std::fabs(speculative_state.vehicle_state.longitudinal_vel - actual_state.vehicle_state.longitudinal_vel);
+        auto time_diff = std::fabs((speculative_state.target_time - actual_state.target_time).toSec());
+        return distance <= junction_tolerance_ && speed_diff <= junction_speed_tolerance_ && time_diff <= junction_time_tolerance_;
+    }
+
     bool PlanDelegator::isTrajectoryLongEnough(const cav_msgs::TrajectoryPlan& plan) const noexcept
     {
         ros::Duration time_diff = plan.trajectory_points.back().target_time - plan.trajectory_points.front().target_time;
         return time_diff.toSec() >= max_trajectory_duration_;
     }
 
+    bool PlanDelegator::appendTrajectorySegment(cav_msgs::TrajectoryPlan& latest_trajectory_plan, cav_msgs::TrajectoryPlan&& segment) const
+    {
+        // validate trajectory before add to the plan
+        if(!isTrajectoryValid(segment))
+        {
+            ROS_WARN_STREAM("Found invalid trajectory with less than 2 trajectory points for " << latest_maneuver_plan_.maneuver_plan_id);
+            return false;
+        }
+        latest_trajectory_plan.trajectory_points.insert(latest_trajectory_plan.trajectory_points.end(),
+                                                        std::make_move_iterator(segment.trajectory_points.begin()),
+                                                        std::make_move_iterator(segment.trajectory_points.end()));
+        latest_trajectory_plan.initial_longitudinal_velocity = segment.initial_longitudinal_velocity;
+        return true;
+    }
+
     cav_msgs::TrajectoryPlan PlanDelegator::planTrajectory()
     {
         cav_msgs::TrajectoryPlan latest_trajectory_plan;
@@ -144,32 +277,39 @@ namespace plan_delegator
             ROS_INFO_STREAM("Guidance is not engaged. Plan delegator will not plan trajectory.");
             return latest_trajectory_plan;
         }
+        // speculation needs the segment start states from a previous cycle
+        if(speculative_planning_ && !junction_states_.empty())
+        {
+            return planTrajectorySpeculative();
+        }
+        junction_states_.clear();
+        // the maneuver plan is copied into the request once per cycle and reused for every plugin call
+        cav_srvs::PlanTrajectory plan_req;
+        plan_req.request.maneuver_plan = latest_maneuver_plan_;
         // iterate through maneuver list to make service call
-    
-        for(const auto& maneuver : latest_maneuver_plan_.maneuvers)
+        for(size_t i = 0; i < latest_maneuver_plan_.maneuvers.size(); ++i)
         {
+            const auto& maneuver = latest_maneuver_plan_.maneuvers[i];
             // ignore expired maneuvers
             if(isManeuverExpired(maneuver))
             {
                 continue;
             }
-            // get corresponding ros service client for plan trajectory
             auto maneuver_planner = GET_MANEUVER_PROPERTY(maneuver, parameters.planning_tactical_plugin);
-            auto client = getPlannerClientByName(maneuver_planner);
-            // compose service request
-            auto plan_req = composePlanTrajectoryRequest(latest_trajectory_plan);
-            if(client.call(plan_req))
+            // update service request
+            plan_req.request.vehicle_state = composeVehicleState(latest_trajectory_plan);
+            plan_req.response = cav_srvs::PlanTrajectory::Response{};
+            if(!latest_trajectory_plan.trajectory_points.empty())
+            {
+                junction_states_[GET_MANEUVER_PROPERTY(maneuver, start_time)] =
+                    composeJunctionState(plan_req.request.vehicle_state, latest_trajectory_plan, maneuver);
+            }
+            if(callPlanner(maneuver_planner, plan_req))
             {
-                // validate trajectory before add to the plan
-                if(!isTrajectoryValid(plan_req.response.trajectory_plan))
+                if(!appendTrajectorySegment(latest_trajectory_plan, std::move(plan_req.response.trajectory_plan)))
                 {
-                    ROS_WARN_STREAM("Found invalid trajectory with less than 2 trajectory points for " << latest_maneuver_plan_.maneuver_plan_id);
                     break;
                 }
-                latest_trajectory_plan.trajectory_points.insert(latest_trajectory_plan.trajectory_points.end(),
-                                                                plan_req.response.trajectory_plan.trajectory_points.begin(),
-                                                                plan_req.response.trajectory_plan.trajectory_points.end());
-                latest_trajectory_plan.initial_longitudinal_velocity = plan_req.response.trajectory_plan.initial_longitudinal_velocity;
                 if(isTrajectoryLongEnough(latest_trajectory_plan))
                 {
                     ROS_INFO_STREAM("Plan Trajectory completed for " << latest_maneuver_plan_.maneuver_plan_id);
@@ -186,6 +326,158 @@ namespace plan_delegator
         return latest_trajectory_plan;
     }
 
+    cav_msgs::TrajectoryPlan PlanDelegator::planTrajectorySpeculative()
+    {
+        // written by the asynchronous call, so it is shared with the call in case the call outlives this cycle
+        struct SpeculativeCallState
+        {
+            cav_srvs::PlanTrajectory plan_req;
+            double latency_ms = 0.0;
+        };
+        struct SpeculativeCall
+        {
+            JunctionState junction_state;
+            std::shared_ptr<SpeculativeCallState> state;
+            std::future<bool> result;
+        };
+
+        // forget the abandoned calls of earlier cycles which have finished
+        abandoned_speculative_calls_.erase(std::remove_if(abandoned_speculative_calls_.begin(), abandoned_speculative_calls_.end(),
+            [](const std::future<bool>& result) { return result.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }),
+            abandoned_speculative_calls_.end());
+
+        cav_msgs::TrajectoryPlan latest_trajectory_plan;
+        ros::Time current_time = ros::Time::now();
+        ros::Time speculation_horizon = current_time + ros::Duration(max_trajectory_duration_);
+
+        // call the plugins of all later maneuvers concurrently from last cycle's segment start states
+        std::map<size_t, SpeculativeCall> speculative_calls;
+        bool first_maneuver = true;
+        for(size_t i = 0; i < latest_maneuver_plan_.maneuvers.size(); ++i)
+        {
+            const auto& maneuver = latest_maneuver_plan_.maneuvers[i];
+            if(isManeuverExpired(maneuver, current_time))
+            {
+                continue;
+            }
+            if(first_maneuver)
+            {
+                // the first segment always starts from the current vehicle state and is planned below
+                first_maneuver = false;
+                continue;
+            }
+            if(GET_MANEUVER_PROPERTY(maneuver, start_time) > speculation_horizon)
+            {
+                break;
+            }
+            // the junction states are only used for the same maneuver, as maneuver plans carry no usable id
+            auto junction_state = junction_states_.find(GET_MANEUVER_PROPERTY(maneuver, start_time));
+            if(junction_state == junction_states_.end() || !isJunctionOfManeuver(junction_state->second, maneuver))
+            {
+                continue;
+            }
+            // each call gets its own client as a persistent client serves one call at a time
+            // and callPlanner may replace it while the speculative call is in flight
+            ros::ServiceClient client = nh_.serviceClient<cav_srvs::PlanTrajectory>(
+                getPlannerClientByName(GET_MANEUVER_PROPERTY(maneuver, parameters.planning_tactical_plugin)).getService());
+            auto& call = speculative_calls[i];
+            call.junction_state = junction_state->second;
+            call.state = std::make_shared<SpeculativeCallState>();
+            call.state->plan_req = composePlanTrajectoryRequest(junction_state->second.vehicle_state);
+            auto state = call.state;
+            call.result = std::async(std::launch::async, [client, state]() mutable
+            {
+                ros::WallTime start_time = ros::WallTime::now();
+                bool success = client.call(state->plan_req);
+                state->latency_ms = (ros::WallTime::now() - start_time).toSec() / MILLISECOND_TO_SECOND;
+                return success;
+            });
+        }
+        // speculative calls which have not returned by this deadline are replanned sequentially
+        auto speculative_deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(speculative_call_timeout_);
+
+        // stitch segments in order and replan any segment whose speculative start does not match the actual junction
+        std::map<ros::Time, JunctionState> next_junction_states;
+        cav_srvs::PlanTrajectory plan_req;
+        plan_req.request.maneuver_plan = latest_maneuver_plan_;
+        for(size_t i = 0; i < latest_maneuver_plan_.maneuvers.size(); ++i)
+        {
+            const auto& maneuver = latest_maneuver_plan_.maneuvers[i];
+            if(isManeuverExpired(maneuver, current_time))
+            {
+                continue;
+            }
+            auto maneuver_planner = GET_MANEUVER_PROPERTY(maneuver, parameters.planning_tactical_plugin);
+            plan_req.request.vehicle_state = composeVehicleState(latest_trajectory_plan);
+            plan_req.response = cav_srvs::PlanTrajectory::Response{};
+            JunctionState actual_junction;
+            bool has_junction = !latest_trajectory_plan.trajectory_points.empty();
+            if(has_junction)
+            {
+                actual_junction = composeJunctionState(plan_req.request.vehicle_state, latest_trajectory_plan, maneuver);
+                next_junction_states[GET_MANEUVER_PROPERTY(maneuver, start_time)] = actual_junction;
+            }
+            bool success = false;
+            auto speculative_call = speculative_calls.find(i);
+            bool speculative_success = false;
+            if(speculative_call != speculative_calls.end())
+            {
+                auto& call = speculative_call->second;
+                if(call.result.wait_until(speculative_deadline) == std::future_status::ready)
+                {
+                    speculative_success = call.result.get();
+                    recordPlannerCallLatency(maneuver_planner, call.state->latency_ms, speculative_success);
+                }
+                else
+                {
+                    ROS_WARN_STREAM("Speculative call to trajectory planner: " << maneuver_planner << " timed out for maneuver " << i << " of plan ID " << latest_maneuver_plan_.maneuver_plan_id);
+                    recordPlannerCallLatency(maneuver_planner, speculative_call_timeout_ / MILLISECOND_TO_SECOND, false);
+                    abandoned_speculative_calls_.push_back(std::move(call.result));
+                }
+            }
+            if(speculative_success && has_junction && isJunctionWithinTolerance(speculative_call->second.junction_state, actual_junction))
+            {
+                plan_req.response = std::move(speculative_call->second.state->plan_req.response);
+                success = true;
+            }
+            else
+            {
+                if(speculative_call != speculative_calls.end())
+                {
+                    ROS_DEBUG_STREAM("Replanning speculative segment for maneuver " << i << " of plan ID " << latest_maneuver_plan_.maneuver_plan_id);
+                }
+                success = callPlanner(maneuver_planner, plan_req);
+            }
+            if(success)
+            {
+                if(!appendTrajectorySegment(latest_trajectory_plan, std::move(plan_req.response.trajectory_plan)))
+                {
+                    break;
+                }
+                if(isTrajectoryLongEnough(latest_trajectory_plan))
+                {
+                    ROS_INFO_STREAM("Plan Trajectory completed for " << latest_maneuver_plan_.maneuver_plan_id);
+                    break;
+                }
+            }
+            else
+            {
+                ROS_WARN_STREAM("Unsuccessful service call to trajectory planner:" << maneuver_planner << " for plan ID " << latest_maneuver_plan_.maneuver_plan_id);
+                break;
+            }
+        }
+        // speculative calls which are no longer needed finish in the background instead of delaying this cycle
+        for(auto& speculative_call : speculative_calls)
+        {
+            if(speculative_call.second.result.valid())
+            {
+                abandoned_speculative_calls_.push_back(std::move(speculative_call.second.result));
+            }
+        }
+        junction_states_.swap(next_junction_states);
+        return latest_trajectory_plan;
+    }
+
     bool PlanDelegator::spinCallback()
     {
         cav_msgs::TrajectoryPlan trajectory_plan = planTrajectory();
@@ -199,6 +491,12 @@ namespace plan_delegator
         {
             ROS_WARN_STREAM("Planned trajectory is empty. It will not be published!");
         }
+        ros::Time now = ros::Time::now();
+        if(!planner_call_latencies_.empty() && (now - last_latency_report_time_).toSec() >= latency_report_period_)
+        {
+            latency_pub_.publish(composeLatencyReport());
+            last_latency_report_time_ = now;
+        }
         return true;
     }
 }
@@ -16,6 +16,7 @@
 
 #include <thread>
 #include <chrono>
+#include <mutex>
 #include <cav_msgs/ManeuverPlan.h>
 #include <cav_srvs/PlanTrajectory.h>
 #include <gtest/gtest.h>
@@ -66,6 +67,21 @@
             {
                 return this->trajectory_planners_;
             }
+
+            void setSpeculativePlanning(bool speculative_planning)
+            {
+                this->speculative_planning_ = speculative_planning;
+            }
+
+            void setSpeculativeCallTimeout(double speculative_call_timeout)
+            {
+                this->speculative_call_timeout_ = speculative_call_timeout;
+            }
+
+            cav_msgs::TrajectoryPlan plan()
+            {
+                return this->planTrajectory();
+            }
     };
 
     TEST(TestPlanDelegator, UnitTestPlanDelegator) {
@@ -120,6 +136,190 @@
         EXPECT_NEAR(1.0, req.request.vehicle_state.X_pos_global, 0.01);
         EXPECT_NEAR(1.0, req.request.vehicle_state.Y_pos_global, 0.01);
         EXPECT_NEAR(1.0, req.request.vehicle_state.longitudinal_vel, 0.1);
+        // test compose speculative plan trajectory request
+        cav_msgs::VehicleState speculative_state;
+        speculative_state.X_pos_global = 1.2;
+        speculative_state.Y_pos_global = 1.2;
+        speculative_state.longitudinal_vel = 1.0;
+        cav_srvs::PlanTrajectory speculative_req = pd.composePlanTrajectoryRequest(speculative_state);
+        EXPECT_NEAR(1.2, speculative_req.request.vehicle_state.X_pos_global, 0.01);
+        EXPECT_NEAR(1.2, speculative_req.request.vehicle_state.Y_pos_global, 0.01);
+        EXPECT_EQ(1, speculative_req.request.maneuver_plan.maneuvers.size());
+        // test junction tolerance
+        maneuver.lane_following_maneuver.parameters.planning_tactical_plugin = "plugin_A";
+        maneuver.lane_following_maneuver.end_time = ros::Time(10.0);
+        plan_delegator::JunctionState actual_junction = pd.composeJunctionState(req.request.vehicle_state, traj_plan, maneuver);
+        EXPECT_EQ(point_2.target_time, actual_junction.target_time);
+        EXPECT_EQ(true, pd.isJunctionOfManeuver(actual_junction, maneuver));
+        maneuver.lane_following_maneuver.end_time = ros::Time(11.0);
+        EXPECT_EQ(false, pd.isJunctionOfManeuver(actual_junction, maneuver));
+        plan_delegator::JunctionState speculative_junction = actual_junction;
+        speculative_junction.vehicle_state = speculative_state;
+        EXPECT_EQ(true, pd.isJunctionWithinTolerance(speculative_junction, actual_junction));
+        speculative_junction.vehicle_state.X_pos_global = 2.0;
+        EXPECT_EQ(false, pd.isJunctionWithinTolerance(speculative_junction, actual_junction));
+        speculative_junction.vehicle_state = speculative_state;
+        speculative_junction.vehicle_state.longitudinal_vel = 2.0;
+        EXPECT_EQ(false, pd.isJunctionWithinTolerance(speculative_junction, actual_junction));
+        speculative_junction.vehicle_state = speculative_state;
+        speculative_junction.target_time = actual_junction.target_time + ros::Duration(1.0);
+        EXPECT_EQ(false, pd.isJunctionWithinTolerance(speculative_junction, actual_junction));
+        // test plugin call latency histogram
+        pd.recordPlannerCallLatency("plugin_A", 3.0, true);
+        pd.recordPlannerCallLatency("plugin_A", 30.0, true);
+        pd.recordPlannerCallLatency("plugin_A", 1000.0, false);
+        diagnostic_msgs::DiagnosticArray report = pd.composeLatencyReport();
+        ASSERT_EQ(1, report.status.size());
+        EXPECT_EQ("plugin_A", report.status[0].name);
+        EXPECT_EQ(diagnostic_msgs::DiagnosticStatus::WARN, report.status[0].level);
+        std::unordered_map<std::string, std::string> values;
+        for(const auto& kv : report.status[0].values)
+        {
+            values[kv.key] = kv.value;
+        }
+        EXPECT_EQ("3", values["calls"]);
+        EXPECT_EQ("1", values["failures"]);
+        EXPECT_EQ("1", values["le_5_ms"]);
+        EXPECT_EQ("0", values["le_10_ms"]);
+        EXPECT_EQ("1", values["le_50_ms"]);
+        EXPECT_EQ("1", values["gt_500_ms"]);
+    }
+
+    TEST(TestPlanDelegator, SpeculativePlanning) {
+        ros::NodeHandle nh = ros::NodeHandle();
+        ros::Time base_time = ros::Time::now();
+        // mock planner which plans a 10 m, 1 s segment from the requested start position
+        // end_speed sets the speed over the last part of the segment without moving its end
+        std::mutex planner_mutex;
+        int call_count = 0;
+        double end_speed = 10.0;
+        double fail_x = -1.0;
+        double delay_x = -1.0;
+        boost::function<bool(cav_srvs::PlanTrajectoryRequest&, cav_srvs::PlanTrajectoryResponse&)> cb =
+            [&](cav_srvs::PlanTrajectoryRequest& req, cav_srvs::PlanTrajectoryResponse& res) -> bool
+        {
+            double x = req.vehicle_state.X_pos_global;
+            bool delay = false;
+            {
+                std::lock_guard<std::mutex> lock(planner_mutex);
+                ++call_count;
+                if(std::fabs(x - fail_x) < 0.01)
+                {
+                    fail_x = -1.0;
+                    return false;
+                }
+                if(std::fabs(x - delay_x) < 0.01)
+                {
+                    delay_x = -1.0;
+                    delay = true;
+                }
+            }
+            if(delay)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            }
+            cav_msgs::TrajectoryPlanPoint start, middle, end;
+            start.x = x;
+            start.target_time = base_time + ros::Duration(x / 10.0);
+            end.x = x + 10.0;
+            end.target_time = start.target_time + ros::Duration(1.0);
+            middle.x = end.x - end_speed * 0.1;
+            middle.target_time = end.target_time - ros::Duration(0.1);
+            res.trajectory_plan.trajectory_points = {start, middle, end};
+            return true;
+        };
+        ros::ServiceServer plugin_A_server = nh.advertiseService("/test_plugins/plugin_A/plan_trajectory", cb);
+        ros::AsyncSpinner spinner(2);
+        spinner.start();
+        ASSERT_TRUE(ros::service::waitForService("/test_plugins/plugin_A/plan_trajectory", ros::Duration(5.0)));
+
+        PlanDelegatorTest pd;
+        pd.setPlanningTopicPrefix("/test_plugins/");
+        pd.setPlanningTopicSuffix("/plan_trajectory");
+        pd.setSpeculativePlanning(true);
+        // long enough for no call to time out unless it is delayed on purpose
+        pd.setSpeculativeCallTimeout(5.0);
+        cav_msgs::GuidanceState guidance_state;
+        guidance_state.state = cav_msgs::GuidanceState::ENGAGED;
+        pd.guidanceStateCallback(cav_msgs::GuidanceStateConstPtr(new cav_msgs::GuidanceState(guidance_state)));
+        cav_msgs::ManeuverPlan plan;
+        for(int i = 0; i < 3; ++i)
+        {
+            cav_msgs::Maneuver maneuver;
+            maneuver.type = cav_msgs::Maneuver::LANE_FOLLOWING;
+            maneuver.lane_following_maneuver.parameters.planning_tactical_plugin = "plugin_A";
+            maneuver.lane_following_maneuver.start_time = base_time + ros::Duration(i);
+            maneuver.lane_following_maneuver.end_time = base_time + ros::Duration(60.0 + i);
+            plan.maneuvers.push_back(maneuver);
+        }
+        pd.maneuverPlanCallback(cav_msgs::ManeuverPlanConstPtr(new cav_msgs::ManeuverPlan(plan)));
+
+        auto expect_full_trajectory = [](const cav_msgs::TrajectoryPlan& trajectory)
+        {
+            ASSERT_EQ(9, trajectory.trajectory_points.size());
+            EXPECT_NEAR(0.0, trajectory.trajectory_points.front().x, 0.001);
+            EXPECT_NEAR(30.0, trajectory.trajectory_points.back().x, 0.001);
+        };
+
+        // the first cycle has no junction states and plans each segment sequentially
+        expect_full_trajectory(pd.plan());
+        EXPECT_EQ(3, call_count);
+
+        // matching junctions are stitched in without replanning
+        expect_full_trajectory(pd.plan());
+        EXPECT_EQ(6, call_count);
+
+        // the junctions are at the same position and time but at a different speed so both later segments are replanned
+        end_speed = 12.0;
+        expect_full_trajectory(pd.plan());
+        EXPECT_EQ(11, call_count);
+        expect_full_trajectory(pd.plan());
+        EXPECT_EQ(14, call_count);
+
+        // a failed speculative call is replanned from the actual junction
+        fail_x = 20.0;
+        expect_full_trajectory(pd.plan());
+        EXPECT_EQ(18, call_count);
+        diagnostic_msgs::DiagnosticArray report = pd.composeLatencyReport();
+        ASSERT_EQ(1, report.status.size());
+        std::unordered_map<std::string, std::string> values;
+        for(const auto& kv : report.status[0].values)
+        {
+            values[kv.key] = kv.value;
+        }
+        EXPECT_EQ("18", values["calls"]);
+        EXPECT_EQ("1", values["failures"]);
+
+        // junction states are not used for a different maneuver plan
+        for(auto& maneuver : plan.maneuvers)
+        {
+            maneuver.lane_following_maneuver.start_time += ros::Duration(0.5);
+        }
+        pd.maneuverPlanCallback(cav_msgs::ManeuverPlanConstPtr(new cav_msgs::ManeuverPlan(plan)));
+        expect_full_trajectory(pd.plan());
+        EXPECT_EQ(21, call_count);
+
+        // a speculative call which does not return in time is replanned sequentially without waiting for it
+        pd.setSpeculativeCallTimeout(0.1);
+        delay_x = 10.0;
+        auto start_time = std::chrono::steady_clock::now();
+        expect_full_trajectory(pd.plan());
+        EXPECT_GT(std::chrono::milliseconds(400), std::chrono::steady_clock::now() - start_time);
+        // let the delayed call finish before counting it
+        std::this_thread::sleep_for(std::chrono::milliseconds(600));
+        EXPECT_EQ(25, call_count);
+        values.clear();
+        for(const auto& kv : pd.composeLatencyReport().status[0].values)
+        {
+            values[kv.key] = kv.value;
+        }
+        EXPECT_EQ("25", values["calls"]);
+        EXPECT_EQ("2", values["failures"]);
+
+        // the finished call is forgotten and the next cycle stitches both speculative segments in again
+        expect_full_trajectory(pd.plan());
+        EXPECT_EQ(28, call_count);
+        spinner.stop();
     }
 
     TEST(TestPlanDelegator, TestPlanDelegator) {
@@ -17,6 +17,7 @@
  */
 
 #include <vector>
+#include <unordered_map>
 #include <cav_msgs/Plugin.h>
 #include <carma_utils/CARMAUtils.h>
 #include <geometry_msgs/PoseStamped.h>
@@ -38,6 +39,18 @@ namespace route_following_plugin
         static constexpr double TWENTY_FIVE_MPH_IN_MS = 11.176;
         static constexpr double FIFTEEN_MPH_IN_MS = 6.7056;
 
+        /**
+         * \brief Route-derived data for one lanelet of the shortest path
+         */
+        struct RouteLaneletInfo
+        {
+            lanelet::Id id;
+            // Route downtrack distance of the end of the lanelet centerline
+            double end_downtrack;
+            // True if the next lanelet of the shortest path is a successor of this lanelet
+            bool next_is_successor;
+        };
+
         /**
          * \brief Default constructor for RouteFollowingPlugin class
          */
@@ -90,6 +103,29 @@ namespace route_following_plugin
          */
         double findSpeedLimit(const lanelet::ConstLanelet& llt);
 
+        /**
+         * \brief Rebuild the cached route table from the current route of the world model.
+         *        Called whenever the route or the map changes so maneuver planning does not need to
+         *        copy the shortest path or query downtrack distances and lanelet relations.
+         *        Speed limits are not cached as map updates can change them without a new route or map
+         */
+        void updateRouteTable();
+
+        /**
+         * \brief Find the index of a lanelet in the cached route table
+         * \param lanelet_id ID of the lanelet to look for
+         * \return Index of the lanelet in route_lanelets_, or -1 if it is not on the shortest path
+         */
+        int findRouteTableIndex(lanelet::Id lanelet_id) const;
+
+        /**
+         * \brief Extend a prior plan which ends with a lane following maneuver of this plugin along the cached route table
+         * \param prior_plan The plan to extend, as received from the arbitrator
+         * \param new_plan The plan to fill with the prior maneuvers followed by the new ones
+         * \return False if the prior plan cannot be extended from the route table, in which case new_plan is not modified
+         */
+        bool extendPriorPlan(const cav_msgs::ManeuverPlan& prior_plan, cav_msgs::ManeuverPlan& new_plan);
+
         //Internal Variables used in unit tests
         // Current vehicle forward speed
         double current_speed_;
@@ -104,6 +140,12 @@ namespace route_following_plugin
         // config limit for vehicle speed limit set as ros parameter
         double config_limit=0.0;
 
+        // Extend a prior plan from the arbitrator instead of replanning from the current position, loaded from config file
+        bool extend_prior_plan_=false;
+
+        // Shortest path lanelets of the current route in path order
+        std::vector<RouteLaneletInfo> route_lanelets_;
+
     private:
 
         // CARMA ROS node handles
@@ -125,6 +167,12 @@ namespace route_following_plugin
         // Plugin discovery message
         cav_msgs::Plugin plugin_discovery_msg_;
 
+        // Lanelet ID to index in route_lanelets_
+        std::unordered_map<lanelet::Id, size_t> route_lanelet_index_;
+
+        // Route which route_lanelets_ was built from
+        carma_wm::LaneletRouteConstPtr route_table_source_;
+
         /**
          * \brief Initialize ROS publishers, subscribers, service servers and service clients
          */
@@ -45,10 +45,14 @@ namespace route_following_plugin
         twist_sub_ = nh_->subscribe("current_velocity", 1, &RouteFollowingPlugin::twist_cd, this);
         
         pnh_->param<double>("minimal_maneuver_duration", mvr_duration_, 16.0);
+        pnh_->param<bool>("extend_prior_plan", extend_prior_plan_, false);
         pnh2_->param<double>("config_speed_limit",config_limit);
         wml_.reset(new carma_wm::WMListener());
         // set world model point form wm listener
         wm_ = wml_->getWorldModel();
+        // route and map updates are the only events which change the cached route table
+        wml_->setRouteCallback([this]() { updateRouteTable(); });
+        wml_->setMapCallback([this]() { updateRouteTable(); });
         ros::CARMANodeHandle::setSpinCallback([this]() -> bool 
         {
            plugin_discovery_pub_.publish(plugin_discovery_msg_);
@@ -69,15 +73,32 @@ namespace route_following_plugin
             ROS_WARN_STREAM("Cannot find any lanelet in map!");
             return true;
         }
-        
-        auto shortest_path = wm_->getRoute()->shortestPath();
+
+        // Rebuild the table if the route changed without the route callback being triggered
+        if(!wm_->getRoute())
+        {
+            ROS_WARN_STREAM("Cannot plan maneuver because no route is found");
+            return true;
+        }
+        if(route_table_source_ != wm_->getRoute())
+        {
+            updateRouteTable();
+        }
+
+        // Extend a prior plan from the arbitrator instead of replanning the maneuvers it already holds.
+        // Only enabled together with the arbitrator warm start, otherwise every tree expansion would be extended too
+        if(extend_prior_plan_ && !req.prior_plan.maneuvers.empty() && extendPriorPlan(req.prior_plan, resp.new_plan))
+        {
+            return true;
+        }
+
         lanelet::ConstLanelet current_lanelet = current_lanelets[0].second;
         int last_lanelet_index = -1;
         for (auto llt : current_lanelets)
         {
             if (boost::geometry::within(current_loc, llt.second.polygon2d()))
             {
-                int potential_index = findLaneletIndexFromPath(llt.second.id(), shortest_path);
+                int potential_index = findRouteTableIndex(llt.second.id());
                 if (potential_index != -1)
                 {
                     last_lanelet_index = potential_index;
@@ -97,33 +118,26 @@ namespace route_following_plugin
 
         double total_maneuver_length = current_progress + mvr_duration_ * target_speed;
         
-        while(current_progress < total_maneuver_length && last_lanelet_index < shortest_path.size())
+        while(current_progress < total_maneuver_length && last_lanelet_index < route_lanelets_.size())
         {
-            ROS_DEBUG_STREAM("Lanlet: " << shortest_path[last_lanelet_index].id());
-            auto p = shortest_path[last_lanelet_index].centerline2d().back();
-            double end_dist = wm_->routeTrackPos(shortest_path[last_lanelet_index].centerline2d().back()).downtrack;
+            const RouteLaneletInfo& route_lanelet = route_lanelets_[last_lanelet_index];
+            ROS_DEBUG_STREAM("Lanlet: " << route_lanelet.id);
+            double end_dist = route_lanelet.end_downtrack;
             double dist_diff = end_dist - current_progress;
             resp.new_plan.maneuvers.push_back(
                 composeManeuverMessage(current_progress, end_dist, 
                                        speed_progress, target_speed, 
-                                       shortest_path[last_lanelet_index].id(), ros::Time::now()));
+                                       route_lanelet.id, ros::Time::now()));
             current_progress += dist_diff;
             speed_progress = target_speed;
-            //get speed limit
-            current_lanelet=shortest_path[last_lanelet_index];  //update current lanelet
-            target_speed=findSpeedLimit(current_lanelet);
+            //get speed limit of the lanelet just planned. It is not cached as map updates such as geofences can change it
+            target_speed = findSpeedLimit(wm_->getMap()->laneletLayer.get(route_lanelet.id));
 
-            if(current_progress >= total_maneuver_length || last_lanelet_index == shortest_path.size() - 1)
+            if(current_progress >= total_maneuver_length || last_lanelet_index == route_lanelets_.size() - 1)
             {
                 break;
             }
-            auto following_lanelets = wm_->getRoute()->followingRelations(shortest_path[last_lanelet_index]);
-            if(following_lanelets.size() == 0)
-            {
-                ROS_WARN_STREAM("Cannot find the following lanelet.");
-                return true;
-            }
-            if(identifyLaneChange(following_lanelets, shortest_path[last_lanelet_index + 1].id()))
+            if(route_lanelet.next_is_successor)
             {
                 ++last_lanelet_index;
             }
@@ -139,6 +153,89 @@ namespace route_following_plugin
         }
         return true;
     }
+    void RouteFollowingPlugin::updateRouteTable()
+    {
+        route_lanelets_.clear();
+        route_lanelet_index_.clear();
+        route_table_source_ = wm_->getRoute();
+        if(!route_table_source_)
+        {
+            return;
+        }
+
+        const lanelet::routing::LaneletPath& shortest_path = route_table_source_->shortestPath();
+        route_lanelets_.reserve(shortest_path.size());
+        route_lanelet_index_.reserve(shortest_path.size());
+        for(size_t i = 0; i < shortest_path.size(); ++i)
+        {
+            const lanelet::ConstLanelet& llt = shortest_path[i];
+            RouteLaneletInfo info;
+            info.id = llt.id();
+            info.end_downtrack = wm_->routeTrackPos(llt.centerline2d().back()).downtrack;
+            info.next_is_successor = i + 1 < shortest_path.size() &&
+                                     identifyLaneChange(route_table_source_->followingRelations(llt), shortest_path[i + 1].id());
+            route_lanelets_.push_back(info);
+            // Keep the first occurrence to match the linear search of findLaneletIndexFromPath
+            route_lanelet_index_.emplace(info.id, i);
+        }
+        ROS_DEBUG_STREAM("Rebuilt route table with " << route_lanelets_.size() << " lanelets");
+    }
+    bool RouteFollowingPlugin::extendPriorPlan(const cav_msgs::ManeuverPlan& prior_plan, cav_msgs::ManeuverPlan& new_plan)
+    {
+        const cav_msgs::Maneuver& last_maneuver = prior_plan.maneuvers.back();
+        if(last_maneuver.type != cav_msgs::Maneuver::LANE_FOLLOWING || 
+           last_maneuver.lane_following_maneuver.parameters.planning_strategic_plugin != "RouteFollowingPlugin")
+        {
+            return false;
+        }
+        int last_lanelet_index;
+        try
+        {
+            last_lanelet_index = findRouteTableIndex(std::stoll(last_maneuver.lane_following_maneuver.lane_id));
+        }
+        catch(const std::exception&)
+        {
+            return false;
+        }
+        // Nothing can be appended past the end of the route or across a lane change
+        if(last_lanelet_index == -1 || !route_lanelets_[last_lanelet_index].next_is_successor)
+        {
+            return false;
+        }
+
+        new_plan.maneuvers = prior_plan.maneuvers;
+        double current_progress = last_maneuver.lane_following_maneuver.end_dist;
+        double speed_progress = last_maneuver.lane_following_maneuver.end_speed;
+        ros::Time current_time = last_maneuver.lane_following_maneuver.end_time;
+        double target_speed = findSpeedLimit(wm_->getMap()->laneletLayer.get(route_lanelets_[last_lanelet_index].id));
+        double total_maneuver_length = current_progress + mvr_duration_ * target_speed;
+        for(size_t i = last_lanelet_index + 1; i < route_lanelets_.size(); ++i)
+        {
+            const RouteLaneletInfo& route_lanelet = route_lanelets_[i];
+            new_plan.maneuvers.push_back(
+                composeManeuverMessage(current_progress, route_lanelet.end_downtrack, 
+                                       speed_progress, target_speed, 
+                                       route_lanelet.id, current_time));
+            current_progress = route_lanelet.end_downtrack;
+            speed_progress = target_speed;
+            current_time = new_plan.maneuvers.back().lane_following_maneuver.end_time;
+            target_speed = findSpeedLimit(wm_->getMap()->laneletLayer.get(route_lanelet.id));
+            if(current_progress >= total_maneuver_length || !route_lanelet.next_is_successor)
+            {
+                break;
+            }
+        }
+        return true;
+    }
+    int RouteFollowingPlugin::findRouteTableIndex(lanelet::Id lanelet_id) const
+    {
+        auto it = route_lanelet_index_.find(lanelet_id);
+        if(it == route_lanelet_index_.end())
+        {
+            return -1;
+        }
+        return it->second;
+    }
     void RouteFollowingPlugin::pose_cb(const geometry_msgs::PoseStampedConstPtr& msg)
     {
         pose_msg_ = geometry_msgs::PoseStamped(*msg.get());
@@ -77,6 +77,144 @@ namespace route_following_plugin
         EXPECT_TRUE(rfp.identifyLaneChange(relations, 0));
     }
 
+    TEST(RouteFollowingPluginTest, testRouteTable)
+    {
+        carma_wm::test::MapOptions options;
+        options.lane_length_=25;
+        options.lane_width_=3.7;
+        options.speed_limit_=carma_wm::test::MapOptions::SpeedLimit::DEFAULT;
+        options.obstacle_=carma_wm::test::MapOptions::Obstacle::NONE;
+        std::shared_ptr<carma_wm::CARMAWorldModel> cmw=carma_wm::test::getGuidanceTestMap(options);
+
+        RouteFollowingPlugin worker;
+        worker.wm_=cmw;
+        worker.updateRouteTable();
+
+        // default route of the guidance test map is 1200 -> 1203
+        ASSERT_EQ(4, worker.route_lanelets_.size());
+        for(size_t i = 0; i < worker.route_lanelets_.size(); ++i)
+        {
+            EXPECT_EQ(1200 + i, worker.route_lanelets_[i].id);
+            EXPECT_NEAR(25.0 * (i + 1), worker.route_lanelets_[i].end_downtrack, 0.0001);
+        }
+        EXPECT_TRUE(worker.route_lanelets_[0].next_is_successor);
+        EXPECT_TRUE(worker.route_lanelets_[2].next_is_successor);
+        EXPECT_FALSE(worker.route_lanelets_[3].next_is_successor);
+        EXPECT_EQ(2, worker.findRouteTableIndex(1202));
+        EXPECT_EQ(-1, worker.findRouteTableIndex(1210));
+
+        // a new route is picked up by the next planning call
+        carma_wm::test::setRouteByIds({1210,1213},cmw);
+        worker.pose_msg_.pose.position.x=1.5*options.lane_width_;
+        worker.pose_msg_.pose.position.y=12.5;
+        worker.current_speed_=10.0;
+
+        cav_srvs::PlanManeuversRequest req;
+        cav_srvs::PlanManeuversResponse resp;
+        ros::Time::init();
+        ASSERT_TRUE(worker.plan_maneuver_cb(req, resp));
+        EXPECT_EQ(0, worker.findRouteTableIndex(1210));
+        ASSERT_FALSE(resp.new_plan.maneuvers.empty());
+        EXPECT_EQ("1210", resp.new_plan.maneuvers[0].lane_following_maneuver.lane_id);
+        EXPECT_NEAR(12.5, resp.new_plan.maneuvers[0].lane_following_maneuver.start_dist, 0.0001);
+        EXPECT_NEAR(25.0, resp.new_plan.maneuvers[0].lane_following_maneuver.end_dist, 0.0001);
+        for(size_t i = 1; i < resp.new_plan.maneuvers.size(); ++i)
+        {
+            EXPECT_EQ(std::to_string(1210 + i), resp.new_plan.maneuvers[i].lane_following_maneuver.lane_id);
+        }
+    }
+
+    TEST(RouteFollowingPluginTest, testSpeedLimitMapUpdate)
+    {
+        carma_wm::test::MapOptions options;
+        options.lane_length_=25;
+        options.lane_width_=3.7;
+        options.speed_limit_=carma_wm::test::MapOptions::SpeedLimit::DEFAULT;
+        options.obstacle_=carma_wm::test::MapOptions::Obstacle::NONE;
+        std::shared_ptr<carma_wm::CARMAWorldModel> cmw=carma_wm::test::getGuidanceTestMap(options);
+        cmw->setConfigSpeedLimit(80.0);
+
+        RouteFollowingPlugin worker;
+        worker.wm_=cmw;
+        worker.updateRouteTable();
+        worker.pose_msg_.pose.position.x=0.5*options.lane_width_;
+        worker.pose_msg_.pose.position.y=12.5;
+        worker.current_speed_=10.0;
+        ros::Time::init();
+
+        cav_srvs::PlanManeuversRequest req;
+        cav_srvs::PlanManeuversResponse resp;
+        ASSERT_TRUE(worker.plan_maneuver_cb(req, resp));
+        ASSERT_LE(2, resp.new_plan.maneuvers.size());
+        lanelet::Velocity old_limit = 25_mph;
+        EXPECT_NEAR(old_limit.value(), resp.new_plan.maneuvers[1].lane_following_maneuver.end_speed, 0.0001);
+
+        // apply a digital speed limit geofence the way WMListenerWorker applies map updates.
+        // Neither the route nor the map callback is triggered and the route is kept
+        carma_wm::test::setSpeedLimit(10_mph, cmw);
+        cmw->setMap(cmw->getMutableMap());
+
+        cav_srvs::PlanManeuversResponse updated;
+        ASSERT_TRUE(worker.plan_maneuver_cb(req, updated));
+        ASSERT_LE(2, updated.new_plan.maneuvers.size());
+        lanelet::Velocity new_limit = 10_mph;
+        for(size_t i = 0; i < updated.new_plan.maneuvers.size(); ++i)
+        {
+            EXPECT_NEAR(new_limit.value(), updated.new_plan.maneuvers[i].lane_following_maneuver.end_speed, 0.0001);
+        }
+    }
+
+    TEST(RouteFollowingPluginTest, testExtendPriorPlan)
+    {
+        carma_wm::test::MapOptions options;
+        options.lane_length_=25;
+        options.lane_width_=3.7;
+        options.speed_limit_=carma_wm::test::MapOptions::SpeedLimit::DEFAULT;
+        options.obstacle_=carma_wm::test::MapOptions::Obstacle::NONE;
+        std::shared_ptr<carma_wm::CARMAWorldModel> cmw=carma_wm::test::getGuidanceTestMap(options);
+
+        RouteFollowingPlugin worker;
+        worker.wm_=cmw;
+        worker.pose_msg_.pose.position.x=0.5*options.lane_width_;
+        worker.pose_msg_.pose.position.y=12.5;
+        worker.current_speed_=10.0;
+
+        // prior plan from the arbitrator ending on the first lanelet of the route 1200 -> 1203
+        cav_srvs::PlanManeuversRequest req;
+        cav_srvs::PlanManeuversResponse resp;
+        req.prior_plan.maneuvers.push_back(worker.composeManeuverMessage(12.5, 25.0, 10.0, 10.0, 1200, ros::Time(10)));
+        ros::Time::init();
+
+        // the prior plan is ignored unless extension is enabled
+        cav_srvs::PlanManeuversResponse not_extended;
+        ASSERT_TRUE(worker.plan_maneuver_cb(req, not_extended));
+        ASSERT_FALSE(not_extended.new_plan.maneuvers.empty());
+        EXPECT_NE(ros::Time(10), not_extended.new_plan.maneuvers[0].lane_following_maneuver.start_time);
+
+        worker.extend_prior_plan_ = true;
+        ASSERT_TRUE(worker.plan_maneuver_cb(req, resp));
+
+        ASSERT_EQ(4, resp.new_plan.maneuvers.size());
+        EXPECT_EQ("1200", resp.new_plan.maneuvers[0].lane_following_maneuver.lane_id);
+        EXPECT_EQ(ros::Time(10), resp.new_plan.maneuvers[0].lane_following_maneuver.start_time);
+        for(size_t i = 1; i < resp.new_plan.maneuvers.size(); ++i)
+        {
+            const auto& previous = resp.new_plan.maneuvers[i - 1].lane_following_maneuver;
+            const auto& current = resp.new_plan.maneuvers[i].lane_following_maneuver;
+            EXPECT_EQ(std::to_string(1200 + i), current.lane_id);
+            EXPECT_NEAR(previous.end_dist, current.start_dist, 0.0001);
+            EXPECT_EQ(previous.end_time, current.start_time);
+        }
+
+        // a prior plan which does not end on the route is replanned from the current position
+        cav_srvs::PlanManeuversResponse replanned;
+        req.prior_plan.maneuvers[0].lane_following_maneuver.lane_id = "1210";
+        ASSERT_TRUE(worker.plan_maneuver_cb(req, replanned));
+        ASSERT_FALSE(replanned.new_plan.maneuvers.empty());
+        EXPECT_EQ("1200", replanned.new_plan.maneuvers[0].lane_following_maneuver.lane_id);
+        EXPECT_NEAR(12.5, replanned.new_plan.maneuvers[0].lane_following_maneuver.start_dist, 0.0001);
+    }
+
     TEST(RouteFollowingPlugin,DISABLED_TestAssociateSpeedLimit)
     {
         //Use Guidance Lib to create map
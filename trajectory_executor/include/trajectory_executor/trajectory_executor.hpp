@@ -39,6 +39,30 @@ namespace trajectory_executor {
      */
     cav_msgs::TrajectoryPlan trimPastPoints(const cav_msgs::TrajectoryPlan &plan);
 
+    /*!
+     * \brief Finds the index of the first point in a TrajectoryPlan with a
+     * target time after the provided time. The points are expected to be
+     * ordered by target time so this is a binary search over the points at
+     * or after start_index.
+     * 
+     * \param plan The plan to search
+     * \param current_time The time points must be after
+     * \param start_index The index of the first point to consider
+     * \return The index of the first future point, or the number of points if
+     * all points are in the past
+     */
+    size_t firstFuturePointIndex(const cav_msgs::TrajectoryPlan &plan, const ros::Time &current_time, size_t start_index = 0);
+
+    /*!
+     * \brief Builds a new message containing the contents of a TrajectoryPlan
+     * starting at the provided point index.
+     * 
+     * \param plan The plan to copy
+     * \param start_index The index of the first point to copy
+     * \return A new message with the copied contents minus the points before start_index
+     */
+    cav_msgs::TrajectoryPlanPtr copyFromPointIndex(const cav_msgs::TrajectoryPlan &plan, size_t start_index);
+
     /**
      * Trajectory Executor package primary worker class
      * 
@@ -91,7 +115,7 @@ namespace trajectory_executor {
              * 
              * \param msg The new TrajectoryPlan message
              */
-            void onNewTrajectoryPlan(const cav_msgs::TrajectoryPlan& msg);
+            void onNewTrajectoryPlan(const cav_msgs::TrajectoryPlanConstPtr& msg);
 
             /*!
              * \brief Monitor the guidance state and set the current trajector as null_ptr 
@@ -103,13 +127,33 @@ namespace trajectory_executor {
              * \brief Timer callback to be invoked at our output tickrate.
              * Outputs current trajectory plan to the first control plugin in
              * it's point list. If this is our second or later timestep on the
-             * same trajectory, consumes the first point in the point list before
-             * transmission.
+             * same trajectory, advances past the points whose target time has
+             * passed before transmission.
              * 
              * \param te The timer event that triggered this callback
              */
             void onTrajEmitTick(const ros::TimerEvent& te);
 
+            /*!
+             * \brief Advances the start of the current trajectory past the
+             * points whose target time is not after current_time. The trimmed
+             * trajectory is only rebuilt when the start index changes.
+             * Expects a current trajectory and _cur_traj_mutex to be held.
+             * 
+             * \param current_time The time points must be after
+             */
+            void advanceCurrentTrajectory(const ros::Time& current_time);
+
+            /*!
+             * \brief Returns the index of the first unexpired point in the current trajectory
+             */
+            size_t getCurrentStartIndex();
+
+            /*!
+             * \brief Returns the current trajectory starting at its first unexpired point
+             */
+            cav_msgs::TrajectoryPlanConstPtr getTrimmedTrajectory();
+
         private:
             // Node handles to separate callback queues
             std::unique_ptr<ros::CARMANodeHandle> _private_nh;
@@ -124,7 +168,9 @@ namespace trajectory_executor {
             std::map<std::string, ros::Publisher> _traj_publisher_map; // Outbound plan publishers
 
             // Trajectory plan tracking data. Synchronized on _cur_traj_mutex
-            std::unique_ptr<cav_msgs::TrajectoryPlan> _cur_traj; 
+            cav_msgs::TrajectoryPlanConstPtr _cur_traj; // Immutable trajectory as received
+            size_t _cur_traj_start_index {0}; // Index of the first unexpired point in _cur_traj
+            cav_msgs::TrajectoryPlanConstPtr _trimmed_traj; // _cur_traj starting at _cur_traj_start_index, rebuilt only when the index changes
             int _timesteps_since_last_traj {0};
             std::mutex _cur_traj_mutex;
             std::string default_control_plugin_;
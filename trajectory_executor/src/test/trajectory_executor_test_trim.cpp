@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2018-2020 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <gtest/gtest.h>
+#include <boost/make_shared.hpp>
+#include "trajectory_executor/trajectory_executor.hpp"
+
+/**
+ * Exposes the trajectory tracking of TrajectoryExecutor so it can be driven
+ * without a running node.
+ */
+class TrajectoryExecutorTestable : public trajectory_executor::TrajectoryExecutor
+{
+    public:
+        using TrajectoryExecutor::onNewTrajectoryPlan;
+        using TrajectoryExecutor::advanceCurrentTrajectory;
+        using TrajectoryExecutor::getCurrentStartIndex;
+        using TrajectoryExecutor::getTrimmedTrajectory;
+};
+
+/*!
+ * \brief Build a 10-point TrajectoryPlan whose points are 0.1 s apart starting at start_time
+ */
+cav_msgs::TrajectoryPlan buildTimedTraj(const ros::Time &start_time, const std::string &trajectory_id) {
+    cav_msgs::TrajectoryPlan plan;
+    plan.header.stamp = start_time;
+    plan.trajectory_id = trajectory_id;
+    plan.initial_longitudinal_velocity = 5.0;
+
+    for (int i = 0; i < 10; i++) {
+        cav_msgs::TrajectoryPlanPoint p;
+        p.controller_plugin_name = "mpc_follower";
+        p.target_time = start_time + ros::Duration(i * 0.1);
+        p.x = 10 * i;
+        p.y = 10 * i;
+        plan.trajectory_points.push_back(p);
+    }
+
+    return plan;
+}
+
+/*!
+ * \brief Test that a plan whose points are all in the past is trimmed to no points
+ */
+TEST(TrajectoryExecutorTrimTest, all_points_expired) {
+    cav_msgs::TrajectoryPlan plan = buildTimedTraj(ros::Time(100.0), "TEST TRAJECTORY 1");
+
+    size_t index = trajectory_executor::firstFuturePointIndex(plan, ros::Time(101.0));
+    ASSERT_EQ(plan.trajectory_points.size(), index);
+
+    cav_msgs::TrajectoryPlanPtr trimmed = trajectory_executor::copyFromPointIndex(plan, index);
+    ASSERT_TRUE(trimmed->trajectory_points.empty());
+    ASSERT_EQ(plan.trajectory_id, trimmed->trajectory_id);
+    ASSERT_EQ(plan.header.stamp, trimmed->header.stamp);
+    ASSERT_EQ(plan.initial_longitudinal_velocity, trimmed->initial_longitudinal_velocity);
+
+    // Indexes past the end are clamped
+    ASSERT_EQ(plan.trajectory_points.size(), trajectory_executor::firstFuturePointIndex(plan, ros::Time(99.0), 20));
+    ASSERT_TRUE(trajectory_executor::copyFromPointIndex(plan, 20)->trajectory_points.empty());
+}
+
+/*!
+ * \brief Test that a plan whose points are all in the future is copied whole
+ */
+TEST(TrajectoryExecutorTrimTest, no_points_expired) {
+    cav_msgs::TrajectoryPlan plan = buildTimedTraj(ros::Time(100.0), "TEST TRAJECTORY 1");
+
+    size_t index = trajectory_executor::firstFuturePointIndex(plan, ros::Time(99.0));
+    ASSERT_EQ(0u, index);
+
+    cav_msgs::TrajectoryPlanPtr trimmed = trajectory_executor::copyFromPointIndex(plan, index);
+    ASSERT_EQ(plan.trajectory_points.size(), trimmed->trajectory_points.size());
+    ASSERT_EQ(plan.trajectory_points.front().target_time, trimmed->trajectory_points.front().target_time);
+    ASSERT_EQ(plan.trajectory_points.back().target_time, trimmed->trajectory_points.back().target_time);
+}
+
+/*!
+ * \brief Test that a point whose target time is exactly the current time counts as expired
+ */
+TEST(TrajectoryExecutorTrimTest, exact_target_time_match) {
+    cav_msgs::TrajectoryPlan plan = buildTimedTraj(ros::Time(100.0), "TEST TRAJECTORY 1");
+
+    size_t index = trajectory_executor::firstFuturePointIndex(plan, plan.trajectory_points[3].target_time);
+    ASSERT_EQ(4u, index);
+
+    cav_msgs::TrajectoryPlanPtr trimmed = trajectory_executor::copyFromPointIndex(plan, index);
+    ASSERT_EQ(6u, trimmed->trajectory_points.size());
+    ASSERT_EQ(plan.trajectory_points[4].target_time, trimmed->trajectory_points.front().target_time);
+
+    // The search never moves back before the start index
+    ASSERT_EQ(6u, trajectory_executor::firstFuturePointIndex(plan, plan.trajectory_points[3].target_time, 6));
+}
+
+/*!
+ * \brief Test that the trimmed trajectory is reused while the start index does not move
+ */
+TEST(TrajectoryExecutorTrimTest, start_index_stable_between_ticks) {
+    TrajectoryExecutorTestable executor;
+    cav_msgs::TrajectoryPlanConstPtr plan = boost::make_shared<cav_msgs::TrajectoryPlan>(buildTimedTraj(ros::Time(100.0), "TEST TRAJECTORY 1"));
+    executor.onNewTrajectoryPlan(plan);
+
+    executor.advanceCurrentTrajectory(ros::Time(100.25));
+    ASSERT_EQ(3u, executor.getCurrentStartIndex());
+    cav_msgs::TrajectoryPlanConstPtr first_trim = executor.getTrimmedTrajectory();
+    ASSERT_EQ(7u, first_trim->trajectory_points.size());
+
+    // No point expires between these ticks so the same message is forwarded again
+    executor.advanceCurrentTrajectory(ros::Time(100.28));
+    ASSERT_EQ(3u, executor.getCurrentStartIndex());
+    ASSERT_EQ(first_trim, executor.getTrimmedTrajectory());
+
+    executor.advanceCurrentTrajectory(ros::Time(100.55));
+    ASSERT_EQ(6u, executor.getCurrentStartIndex());
+    ASSERT_NE(first_trim, executor.getTrimmedTrajectory());
+    ASSERT_EQ(4u, executor.getTrimmedTrajectory()->trajectory_points.size());
+    ASSERT_EQ(7u, first_trim->trajectory_points.size()); // Previously forwarded messages are left untouched
+}
+
+/*!
+ * \brief Test that a new trajectory starts from its first point and is forwarded without copying
+ */
+TEST(TrajectoryExecutorTrimTest, new_trajectory_resets_start_index) {
+    TrajectoryExecutorTestable executor;
+    cav_msgs::TrajectoryPlanConstPtr plan_1 = boost::make_shared<cav_msgs::TrajectoryPlan>(buildTimedTraj(ros::Time(100.0), "TEST TRAJECTORY 1"));
+    executor.onNewTrajectoryPlan(plan_1);
+    executor.advanceCurrentTrajectory(ros::Time(100.55));
+    ASSERT_EQ(6u, executor.getCurrentStartIndex());
+
+    cav_msgs::TrajectoryPlanConstPtr plan_2 = boost::make_shared<cav_msgs::TrajectoryPlan>(buildTimedTraj(ros::Time(100.5), "TEST TRAJECTORY 2"));
+    executor.onNewTrajectoryPlan(plan_2);
+    ASSERT_EQ(0u, executor.getCurrentStartIndex());
+    ASSERT_EQ(plan_2, executor.getTrimmedTrajectory());
+
+    executor.advanceCurrentTrajectory(ros::Time(100.55));
+    ASSERT_EQ(1u, executor.getCurrentStartIndex());
+    ASSERT_EQ("TEST TRAJECTORY 2", executor.getTrimmedTrajectory()->trajectory_id);
+    ASSERT_EQ(9u, executor.getTrimmedTrajectory()->trajectory_points.size());
+}
+
+/*!
+ * \brief Main entrypoint for unit tests
+ */
+int main (int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -17,23 +17,37 @@
 #include "trajectory_executor/trajectory_executor.hpp"
 #include <ros/ros.h>
 #include <utility>
+#include <algorithm>
+#include <boost/make_shared.hpp>
 #include <cav_msgs/SystemAlert.h>
 #include <exception>
 
 namespace trajectory_executor 
 {
     cav_msgs::TrajectoryPlan trimPastPoints(const cav_msgs::TrajectoryPlan &plan) {
-        cav_msgs::TrajectoryPlan out(plan);
-        out.trajectory_points = std::vector<cav_msgs::TrajectoryPlanPoint>();
-
-        ros::Time current_time = ros::Time::now();
+        return *copyFromPointIndex(plan, firstFuturePointIndex(plan, ros::Time::now()));
+    }
 
-        for (int i = 0; i < plan.trajectory_points.size(); i++) {
-            if (plan.trajectory_points[i].target_time > current_time) {
-                out.trajectory_points.push_back(plan.trajectory_points[i]);
-            }
+    size_t firstFuturePointIndex(const cav_msgs::TrajectoryPlan &plan, const ros::Time &current_time, size_t start_index) {
+        if (start_index >= plan.trajectory_points.size()) {
+            return plan.trajectory_points.size();
         }
 
+        auto it = std::upper_bound(plan.trajectory_points.begin() + start_index, plan.trajectory_points.end(), current_time,
+            [](const ros::Time &time, const cav_msgs::TrajectoryPlanPoint &point) { return time < point.target_time; });
+
+        return std::distance(plan.trajectory_points.begin(), it);
+    }
+
+    cav_msgs::TrajectoryPlanPtr copyFromPointIndex(const cav_msgs::TrajectoryPlan &plan, size_t start_index) {
+        cav_msgs::TrajectoryPlanPtr out = boost::make_shared<cav_msgs::TrajectoryPlan>();
+        out->header = plan.header;
+        out->trajectory_id = plan.trajectory_id;
+        out->initial_longitudinal_velocity = plan.initial_longitudinal_velocity;
+
+        start_index = std::min(start_index, plan.trajectory_points.size());
+        out->trajectory_points.assign(plan.trajectory_points.begin() + start_index, plan.trajectory_points.end());
+
         return out;
     }
 
@@ -59,14 +73,17 @@ namespace trajectory_executor
         return out;
     }
     
-    void TrajectoryExecutor::onNewTrajectoryPlan(const cav_msgs::TrajectoryPlan& msg)
+    void TrajectoryExecutor::onNewTrajectoryPlan(const cav_msgs::TrajectoryPlanConstPtr& msg)
     {
         std::unique_lock<std::mutex> lock(_cur_traj_mutex); // Acquire lock until end of this function scope
         ROS_DEBUG("Received new trajectory plan!");
-        ROS_DEBUG_STREAM("New Trajectory plan ID: " << msg.trajectory_id);
-        ROS_DEBUG_STREAM("New plan contains " << msg.trajectory_points.size() << " points");
+        ROS_DEBUG_STREAM("New Trajectory plan ID: " << msg->trajectory_id);
+        ROS_DEBUG_STREAM("New plan contains " << msg->trajectory_points.size() << " points");
 
-        _cur_traj = std::unique_ptr<cav_msgs::TrajectoryPlan>(new cav_msgs::TrajectoryPlan(msg));
+        // The received message is shared and never modified so it can be forwarded without copying
+        _cur_traj = msg;
+        _cur_traj_start_index = 0;
+        _trimmed_traj = msg;
         _timesteps_since_last_traj = 0;
         ROS_DEBUG_STREAM("Successfully swapped trajectories!");
     }
@@ -77,6 +94,7 @@ namespace trajectory_executor
         if(msg.state==cav_msgs::GuidanceState::INACTIVE)
         {
         	_cur_traj= nullptr;
+        	_trimmed_traj = nullptr;
         }
 
     }
@@ -88,9 +106,31 @@ namespace trajectory_executor
         if(msg->state != cav_msgs::GuidanceState::ENGAGED)
         {
         	_cur_traj= nullptr;
+        	_trimmed_traj = nullptr;
+        }
+    }
+
+    void TrajectoryExecutor::advanceCurrentTrajectory(const ros::Time& current_time)
+    {
+        size_t start_index = firstFuturePointIndex(*_cur_traj, current_time, _cur_traj_start_index);
+        if (start_index != _cur_traj_start_index) {
+            _cur_traj_start_index = start_index;
+            _trimmed_traj = copyFromPointIndex(*_cur_traj, _cur_traj_start_index);
         }
     }
 
+    size_t TrajectoryExecutor::getCurrentStartIndex()
+    {
+        std::unique_lock<std::mutex> lock(_cur_traj_mutex);
+        return _cur_traj_start_index;
+    }
+
+    cav_msgs::TrajectoryPlanConstPtr TrajectoryExecutor::getTrimmedTrajectory()
+    {
+        std::unique_lock<std::mutex> lock(_cur_traj_mutex);
+        return _trimmed_traj;
+    }
+
     void TrajectoryExecutor::onTrajEmitTick(const ros::TimerEvent& te)
     {
         std::unique_lock<std::mutex> lock(_cur_traj_mutex);
@@ -98,11 +138,11 @@ namespace trajectory_executor
 
         if (_cur_traj != nullptr) {
             if (_timesteps_since_last_traj > 0) {
-                _cur_traj = std::unique_ptr<cav_msgs::TrajectoryPlan>(new cav_msgs::TrajectoryPlan(trimPastPoints(*_cur_traj)));
+                advanceCurrentTrajectory(ros::Time::now());
             }
-            if (!_cur_traj->trajectory_points.empty()) {
+            if (_cur_traj_start_index < _cur_traj->trajectory_points.size()) {
                 // Determine the relevant control plugin for the current timestep
-                std::string control_plugin = _cur_traj->trajectory_points[0].controller_plugin_name;
+                std::string control_plugin = _cur_traj->trajectory_points[_cur_traj_start_index].controller_plugin_name;
                 // if it instructed to use default control_plugin
                 if (control_plugin == "default" || control_plugin =="")
                     control_plugin = default_control_plugin_;
@@ -112,7 +152,7 @@ namespace trajectory_executor
                     ROS_DEBUG("Found match for control plugin %s at point %d in current trajectory!",
                         control_plugin.c_str(),
                         _timesteps_since_last_traj);
-                    it->second.publish(*_cur_traj);
+                    it->second.publish(_trimmed_traj);
                 } else {
                     std::ostringstream description_builder;
                     description_builder << "No match found for control plugin " 
@@ -161,10 +201,10 @@ namespace trajectory_executor
         ROS_DEBUG_STREAM("Initalized params with default_spin_rate " << _default_spin_rate 
             << " and trajectory_publish_rate " << _min_traj_publish_tickrate_hz);
 
-        this->_plan_sub = this->_public_nh->subscribe<const cav_msgs::TrajectoryPlan&>("trajectory", 5, &TrajectoryExecutor::onNewTrajectoryPlan, this);
+        this->_plan_sub = this->_public_nh->subscribe("trajectory", 5, &TrajectoryExecutor::onNewTrajectoryPlan, this);
         this->_state_sub = this->_public_nh->subscribe<cav_msgs::GuidanceState>("state", 5, &TrajectoryExecutor::guidanceStateMonitor, this);
 
-        this->_cur_traj = std::unique_ptr<cav_msgs::TrajectoryPlan>();
+        this->_cur_traj = nullptr;
         ROS_DEBUG("Subscribed to inbound trajectory plans.");
 
         ROS_DEBUG("Setting up publishers for control plugin topics...");